@@ -0,0 +1,31 @@
+#pragma once
+#include <lvgl.h>
+
+/*
+    Arc updates that only invalidate the ring sector that actually changed.
+
+    lv_arc_set_value() invalidates the bounding box of the changed angle range,
+    which for a large move on a 240 px ring is a square reaching into the middle
+    of the screen and pulls every overlapping arc into the redraw. These helpers
+    change the arc with display invalidation switched off and then invalidate the
+    sector as a chain of small boxes hugging the ring, TILE_DEGREES at a time, so
+    a meter step costs roughly arc width x chord length pixels.
+*/
+class ArcSectorUpdater
+{
+public:
+    static const int32_t TILE_DEGREES = 10;
+
+    static void setValue(lv_obj_t *arc, int32_t value);
+    static void setAngles(lv_obj_t *arc, int32_t startAngle, int32_t endAngle); // indicator angles, like lv_arc_set_angles
+
+    // Angles in the arc's own frame (before rotation), from start clockwise to end
+    static void invalidateSector(lv_obj_t *arc, int32_t startAngle, int32_t endAngle);
+
+    // Centre and outer radius the same way lv_arc derives them for drawing
+    static void arcCenter(lv_obj_t *arc, lv_point_t &center, int32_t &radius);
+    static int32_t indicatorInset(lv_obj_t *arc); // indicator radius = radius - inset
+
+private:
+    static int32_t valueToAngle(lv_obj_t *arc, int32_t value);
+};
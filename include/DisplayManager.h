@@ -6,6 +6,13 @@
 #include <Preferences.h>
 #include "VoicemeeterProtocol.h"
 #include "NetworkingManager.h"
+#include "TripleBuffer.h"
+#include "PredictedState.h"
+#include "MeterEngine.h"
+#include "DmaDisplayDriver.h"
+#include "StripMap.h"
+#include "RoutingMatrix.h"
+#include "StateDiff.h"
 #include "ui/ui.h"
 
 // Forward declaration
@@ -14,11 +21,10 @@ class PowerManager;
 #define dbMinOffset 6000
 #define TFTSIZE 240
 #define arcOffsetAngle 40
-#define BUF_SIZE 240 * 240
 
-#define numVolumeArcs 3
-#define numBuses 3
-#define numOutputs 3
+#define numVolumeArcs STRIP_MAP_SLOTS
+#define numBuses STRIP_MAP_SLOTS // output grid rows, one per mapped strip
+#define numOutputs STRIP_MAP_BUSES
 
 enum UiState
 {
@@ -29,6 +35,14 @@ enum UiState
     OUTPUTS
 };
 
+// Why the display task was woken; any of them makes the next frame render
+enum DisplayWakeReason : uint8_t
+{
+    WAKE_PACKET = 0x01, // RT packet changed something on screen
+    WAKE_INPUT = 0x02,  // knob movement
+    WAKE_STATE = 0x04   // connection or battery state
+};
+
 class DisplayManager
 {
 public:
@@ -36,49 +50,90 @@ public:
     void begin();
     void begin(class PowerManager *powerMgr, byte lastIPDigit = -1);
     void update(byte displayShouldBeOn, byte reducePowerMode);
-    void showLatestVoicemeeterData(const tagVBAN_VMRT_PACKET &packet);
+    void setPacketSource(TripleBuffer<RTSnapshot> *source) { packetSource = source; }
+    void setMeterSource(MeterPeakCapture *source) { meterSource = source; }
+    void setStripMap(const StripMap *map) { stripMap = map; } // before begin()
+    void setMeterBallistics(const MeterBallistics &ballistics) { meterEngine.setBallistics(ballistics); }
     void showLatestBatteryData(float battPerc, int chgTime, float battVolt);
     void showIpAddress(uint32_t address);
     void setConnectionStatus(bool connected);
     void setIsInteracting(bool interacting);
-    std::vector<NetworkCommand> getIssuedCommands();
+    void predictVolume(uint8_t channel, int16_t gainDb100); // safe to call from other tasks
+    static void requestFrame(uint8_t reasons);              // safe to call from other tasks
+    bool takeIssuedCommand(NetworkCommand &command); // next UI command in issue order, false once drained
     long getLastTouchTime() { return lastTouchTime; }
     UiState getCurrentScreen() { return currentScreen; }
     short getSelectedVolumeArc() { return selectedVolumeArc; }
+    FlushStats getFlushStats() const { return displayDriver.getFlushStats(); }
 
 private:
+    static const unsigned long ACTIVE_HOLD_MS = 500; // keep rendering this long after the last event
+    static const unsigned long TOUCH_POLL_MS = 50;   // idle wake-up to look for touches
+
     static TFT_eSPI tft;
     static CST816S touch;
-    static tagVBAN_VMRT_PACKET latestVoicemeeterData;
+    static const tagVBAN_VMRT_PACKET *latestVoicemeeterData; // snapshot owned by the display task until the next acquire
+    TripleBuffer<RTSnapshot> *packetSource = nullptr;
+    uint32_t stateStamp = 0; // RT_REGION_STATE stamp of latestVoicemeeterData
+    static PredictedState predictedState; // optimistic gains/routing layered over latestVoicemeeterData
+    MeterPeakCapture *meterSource = nullptr;
+    static const StripMap *stripMap; // resolved strip/level/bus indices per ring
+    MeterEngine meterEngine; // smoothed levels and peak markers, advanced once per rendered frame
     Preferences usbSerialPreferences;
     static long lastTouchTime;
     static bool connectionStatus;
     static short selectedVolumeArc;
     UiState currentScreen = LOADING;
+    lv_indev_t *touchIndev = nullptr;
+    unsigned long renderActiveUntil = 0; // frames render until then; afterwards the task sleeps until woken
+    bool isRenderActive() const { return millis() < renderActiveUntil; }
     class PowerManager *powerManager = nullptr; // reference to power manager for display power control
     void setupLvglVaribleReferences();
     void updateArcs();
-    void updateOutputButtons(bool previewButtons);
-    short getStripLevel(byte channel);
+    void updateOutputButtons();
+    void updateRoutingMatrix();
+    void getStripStates(uint32_t states[StateChanges::NUM_CHANNELS]); // reported stripState with routing predictions applied
+    static void bindRoutingPage();
+    short getStripLevel(byte strip);
     short getOutputLevel(byte channel);
+    short getOutputPeak(byte channel);
+    static lv_obj_t *createPeakMarker(lv_obj_t *levelArc);
+    static void setPeakMarker(lv_obj_t *marker, lv_obj_t *levelArc, int value);
     float convertLevelToPercent(int level);
     float convertLevelToDb(int level);
-    static bool getStripOutputEnabled(byte stripNo, byte outputNo);
     void setUSBSerialEnabled(bool enabled);
+    void applyPredictions();
     static uint32_t my_tick(void);
 
-    // initialse the buffer with all zeros
-    uint8_t lv_buffer[BUF_SIZE] = {0};
+    // Owns the two DMA stripe buffers LVGL renders into
+    DmaDisplayDriver displayDriver;
 
     // For monitor: arc sets for each strip and outputs
     static lv_obj_t *strip_arcs[numVolumeArcs];   // Main volume arc
     static lv_obj_t *level_arcs_l[numVolumeArcs]; // Left channel level arc
     static lv_obj_t *level_arcs_r[numVolumeArcs]; // Right channel level arc
+    static lv_obj_t *peak_markers_l[numVolumeArcs]; // Peak-hold tick over the left level arc
+    static lv_obj_t *peak_markers_r[numVolumeArcs];
     static lv_obj_t *label_db;
     static char dbLabelText[16];
 
     // For outputs: grid buttons
     static lv_obj_t *output_buttons[numBuses][numOutputs];
+    static RoutingMatrix routingMatrix; // which strips and buses the Output Matrix buttons show
+    static lv_obj_t *matrix_page_label;
+    StateDiff previewDiff; // routing bits the Monitor preview buttons show
+    StateDiff matrixDiff;  // routing bits the Output Matrix buttons show
+
+    // Packet state stamp and prediction revision a routing grid was last built from
+    struct RoutingSeen
+    {
+        bool valid = false;
+        uint32_t stateStamp = 0;
+        uint32_t routingRevision = 0;
+    };
+    RoutingSeen previewSeen;
+    RoutingSeen matrixSeen;
+    bool routingChangedSince(RoutingSeen &seen);
 
     /* LVGL styles for arcs */
     static lv_style_t style_arc_main;      // Main strip volume arc background
@@ -90,10 +145,10 @@ private:
     static void output_btn_event_cb(lv_event_t *e);
     static void ui_event_Monitor_Callback(lv_event_t *e);
     static void ui_event_IP_Change_Callback(lv_event_t *e);
-    static bool find_output_button(lv_obj_t *btn, int &busIdx, int &outIdx);
+    static void ui_event_OutputMatrix_Callback(lv_event_t *e);
+    static int find_output_button(lv_obj_t *btn); // routing matrix pool cell, -1 if not a matrix button
 
-    std::vector<NetworkCommand> issuedCommands;
-    void sendCommandString(NetworkCommandType type, const String &command);
+    void sendCommandString(NetworkCommandType type, const char *command);
 
     struct pendingButton
     {
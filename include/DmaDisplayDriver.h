@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include <lvgl.h>
+
+// Counters kept by the flush callback; render time overlapping a transfer shows up as little or no wait
+struct FlushStats
+{
+    uint32_t flushes = 0;
+    uint64_t pixels = 0;
+    uint64_t renderUs = 0;  // LVGL drawing before each flush: since the refresh started or the previous buffer was handed back
+    uint64_t waitUs = 0;    // flush blocked on the previous DMA transfer
+    uint32_t maxWaitUs = 0;
+    uint32_t frames = 0;         // completed refreshes (last stripe of a frame flushed)
+    uint32_t maxFramePixels = 0; // largest dirty area pushed in one refresh
+};
+
+/*
+    LVGL display driver for the GC9A01 that pushes stripes with SPI DMA.
+
+    Two DMA-capable stripe buffers are handed to LVGL in partial mode. The flush callback
+    waits for the previous transfer, starts the next one and returns the buffer to LVGL
+    at once, so the next stripe is rendered into the other buffer while this one is
+    still on the wire. If only one buffer can be allocated it falls back to waiting for
+    each transfer before giving the buffer back.
+*/
+class DmaDisplayDriver
+{
+public:
+    static const uint16_t BUF_LINES = 40; // 240 x 40 x RGB565 = 19.2 KB per buffer
+
+    lv_display_t *create(TFT_eSPI &tft, int32_t width, int32_t height);
+
+    // Blocks until the last transfer is done; call before sending the panel anything else
+    void waitIdle();
+
+    FlushStats getFlushStats() const { return stats; }
+    void resetFlushStats() { stats = FlushStats(); }
+    static uint32_t estimatedTransferUs(uint64_t pixels); // at SPI_FREQUENCY, for comparing against waitUs
+
+private:
+    static void flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map);
+    static void resolutionChanged(lv_event_t *e);
+    static void refreshStarted(lv_event_t *e);
+
+    TFT_eSPI *tft = nullptr;
+    uint16_t *buffers[2] = {nullptr, nullptr};
+    bool doubleBuffered = false;
+    unsigned long lastReadyUs = 0;
+    uint32_t framePixels = 0; // pixels of the refresh in progress
+    FlushStats stats;
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+
+/*
+    Integer angle math for the rotary encoder.
+
+    Angles are Q15 fractions of a half turn: -32768 is -180 degrees and 32767 is just
+    under +180, so the int16_t range covers exactly one revolution. Subtracting two
+    angles and truncating back to int16_t gives the shortest signed difference, which
+    is all the unwrapping across the 0/360 boundary needs.
+
+    fixedAtan2 reduces to the first octant and interpolates a 65-entry atan table;
+    the error against libm is below 0.01 degrees (tools/fixed_atan2_bench).
+*/
+typedef int16_t angle_q15_t;
+
+static const int32_t ANGLE_Q15_HALF_TURN = 32768;
+
+angle_q15_t fixedAtan2(int32_t y, int32_t x);
+
+// Shortest signed rotation from -> to, in Q15 half turns
+inline int16_t angleQ15Delta(angle_q15_t from, angle_q15_t to)
+{
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint16_t>(to) - static_cast<uint16_t>(from)));
+}
+
+inline int32_t degreesToAngleQ15(float degrees)
+{
+    float scaled = degrees * (ANGLE_Q15_HALF_TURN / 180.0f);
+    return static_cast<int32_t>(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+}
+
+inline float angleQ15ToDegrees(int32_t angle)
+{
+    return angle * (180.0f / ANGLE_Q15_HALF_TURN);
+}
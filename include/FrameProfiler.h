@@ -0,0 +1,84 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+    Per-frame phase timing for the display task.
+
+    Build with -D FRAME_PROFILER to enable; otherwise the PROFILE_* macros expand to
+    nothing and no profiler object exists. Each rendered frame stores one microsecond
+    duration per phase (saturating at 65535) and the number of pixels flushed in a
+    fixed ring of the last FRAMES frames; min/avg/p99 are only computed when a dump
+    is requested, so recording costs a handful of micros() calls per frame.
+
+    Dumps go to Serial as CSV ("prof") or as a compact binary block ("profbin"):
+      "FPRF" | version u8 | phase count u8 | frame count u16 | frames x phases x u16, little endian
+*/
+enum ProfilePhase : uint8_t
+{
+    PROFILE_SYNC,    // packet acquire, predictions, screen selection
+    PROFILE_ARCS,    // updateArcs
+    PROFILE_BUTTONS, // updateOutputButtons
+    PROFILE_RENDER,  // lv_timer_handler without the flush callbacks
+    PROFILE_FLUSH,   // flush callbacks, including waits on the previous DMA transfer
+    PROFILE_FRAME,   // whole frame
+    PROFILE_PIXELS,  // not a time: pixels flushed this frame (240 x 240 fits in u16)
+    NUM_PROFILE_PHASES
+};
+
+#ifdef FRAME_PROFILER
+
+class FrameProfiler
+{
+public:
+    static const uint16_t FRAMES = 128;
+    static const uint8_t FORMAT_VERSION = 2;
+
+    enum DumpFormat : uint8_t
+    {
+        DUMP_NONE,
+        DUMP_CSV,
+        DUMP_BINARY
+    };
+
+    void beginFrame();
+    void mark(ProfilePhase phase);                  // time since the previous mark goes to phase
+    void add(ProfilePhase phase, uint32_t us);      // time measured elsewhere, e.g. in the flush callback
+    void endFrame();
+
+    // Safe from any task; the dump is written by the display task at the end of its next frame
+    void requestDump(DumpFormat format) { pendingDump = format; }
+
+private:
+    struct PhaseSummary
+    {
+        uint16_t min, avg, p99;
+    };
+
+    void dump(DumpFormat format);
+    PhaseSummary summarize(uint8_t phase, uint16_t count) const;
+
+    uint16_t frames[FRAMES][NUM_PROFILE_PHASES] = {};
+    uint32_t current[NUM_PROFILE_PHASES] = {};
+    uint32_t frameStartUs = 0;
+    uint32_t lastMarkUs = 0;
+    uint32_t frameCount = 0;
+    volatile DumpFormat pendingDump = DUMP_NONE;
+};
+
+extern FrameProfiler frameProfiler;
+
+#define PROFILE_BEGIN_FRAME() frameProfiler.beginFrame()
+#define PROFILE_MARK(phase) frameProfiler.mark(phase)
+#define PROFILE_ADD(phase, us) frameProfiler.add(phase, us)
+#define PROFILE_END_FRAME() frameProfiler.endFrame()
+#define PROFILE_REQUEST_DUMP(format) frameProfiler.requestDump(FrameProfiler::format)
+
+#else
+
+#define PROFILE_BEGIN_FRAME() ((void)0)
+#define PROFILE_MARK(phase) ((void)0)
+#define PROFILE_ADD(phase, us) ((void)0)
+#define PROFILE_END_FRAME() ((void)0)
+#define PROFILE_REQUEST_DUMP(format) ((void)0)
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include "VBANCommandBuilder.h"
+
+/*
+    Coalesces rotary gain changes into at most one command per strip per flush interval.
+
+    Deltas are merged into an absolute per-strip target (in dB * 100, like the RT packet)
+    that is clamped to Voicemeeter's gain range, so a fast spin turns into a handful of
+    idempotent "Strip[n].Gain = x" statements instead of dozens of tiny increments.
+    The first change after a quiet period and any change of direction go out immediately,
+    later ones wait for the interval to elapse.
+*/
+class GainAccumulator
+{
+public:
+    static const uint8_t NUM_STRIPS = 8;
+    static const int16_t GAIN_MIN_DB100 = -6000;
+    static const int16_t GAIN_MAX_DB100 = 1200;
+
+    explicit GainAccumulator(unsigned long flushIntervalMs = 100, unsigned long resyncAfterMs = 1000);
+
+    // reportedGainDb100 is Voicemeeter's last known gain, used as the base once the strip has been idle
+    void add(uint8_t strip, float dbDelta, int16_t reportedGainDb100, unsigned long now);
+
+    // Writes the next due command into out and returns true, or returns false when nothing is due
+    bool popCommand(unsigned long now, VBANCommandWriter &out);
+
+    bool hasPending() const;
+    int16_t getTarget(uint8_t strip) const { return strips[strip].targetDb100; }
+
+private:
+    struct StripAccumulator
+    {
+        int16_t targetDb100 = 0;     // absolute gain we want Voicemeeter to have
+        int16_t sentDb100 = 0;       // last value actually sent
+        int8_t lastDirection = 0;    // sign of the previous delta
+        bool pending = false;        // target differs from what was sent
+        bool flushNow = false;       // skip the interval (first change or direction change)
+        unsigned long lastAddTime = 0;
+        unsigned long lastFlushTime = 0;
+    };
+
+    StripAccumulator strips[NUM_STRIPS];
+    unsigned long flushIntervalMs;
+    unsigned long resyncAfterMs;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <stdint.h>
+
+struct KnobFilterConfig
+{
+    enum FilterType : uint8_t
+    {
+        FILTER_NONE,
+        FILTER_ONE_EURO,  // adaptive low-pass: smooth when slow, little lag when fast
+        FILTER_ALPHA_BETA // fixed-gain position/velocity tracker
+    };
+
+    FilterType type = FILTER_ONE_EURO;
+    float minCutoffHz = 1.0f;  // one-euro: cutoff at rest (lower = less jitter)
+    float beta = 0.05f;        // one-euro: cutoff increase per deg/s of speed
+    float speedCutoffHz = 1.0f; // one-euro: smoothing of the speed estimate
+    float alpha = 0.35f;       // alpha-beta: position correction gain
+    float betaAB = 0.05f;      // alpha-beta: velocity correction gain
+
+    float deadbandDeg = 1.0f; // backlash on the filtered angle, only felt when reversing
+    float degreesPerDb = 9.0f; // knob travel per dB at unity acceleration
+
+    // Velocity curve: acceleration factor is slowGain up to slowSpeedDps, then rises linearly to fastGain at fastSpeedDps
+    float slowSpeedDps = 30.0f;
+    float fastSpeedDps = 360.0f;
+    float slowGain = 0.5f;
+    float fastGain = 4.0f;
+};
+
+/*
+    Turns timestamped encoder angles into gain changes.
+
+    Each sample is filtered (one-euro or alpha-beta, on the unwrapped angle), passed
+    through a small backlash so sensor noise at rest does not creep the gain, and the
+    remaining movement is scaled by a velocity curve: slow turns give fine steps, fast
+    sweeps cover the range in less than a turn. Output accumulates until takeDb() and is
+    handed out in 0.01 dB steps, the resolution Voicemeeter reports gains with, so slow
+    movement is never rounded away.
+
+    Single-threaded: fed and read by the control loop.
+*/
+class KnobFilter
+{
+public:
+    explicit KnobFilter(const KnobFilterConfig &config = KnobFilterConfig());
+
+    void setConfig(const KnobFilterConfig &config);
+    const KnobFilterConfig &getConfig() const { return config; }
+
+    // angleDeltaDeg is the unwrapped rotation since the previous sample
+    void addSample(uint32_t timestampUs, float angleDeltaDeg);
+
+    // Returns the gain change (dB, multiple of 0.01) accumulated since the last call
+    float takeDb();
+
+    float getSpeedDps() const { return speedDps; }
+    void reset();
+
+private:
+    float smoothingFactor(float cutoffHz, float dt) const;
+    float velocityGain(float speed) const;
+
+    KnobFilterConfig config;
+    bool primed = false;
+    uint32_t lastTimestampUs = 0;
+    float rawAngle = 0;      // unwrapped input angle
+    float filteredAngle = 0;
+    float speedDps = 0;      // filtered angular speed, signed
+    float anchorAngle = 0;   // backlash follower
+    float pendingDb100 = 0;  // output not yet taken, in dB * 100
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+
+enum LinkState : uint8_t
+{
+    LINK_PROBING,   // registered (or trying to), no RT packet yet
+    LINK_STREAMING, // packets arriving at the expected rate
+    LINK_DEGRADED,  // a few intervals of silence: still shown as connected, re-registering
+    LINK_LOST       // long silence: the display falls back to Loading
+};
+
+/*
+    Connection state machine for the RT stream, driven from the loop task.
+
+    Silence is measured against the packet interval actually observed, so a stalled
+    stream is noticed within a few packets instead of after a fixed 5 s. While
+    streaming, the registration (valid 15 s, see VBAN_RT_REGISTER_PACKET) is renewed
+    every RENEW_MS; once packets stop, re-registration starts immediately and backs off
+    exponentially up to BACKOFF_MAX_MS. Nothing is sent while Wi-Fi is down; the
+    reconnect resets the backoff and registers straight away.
+
+    update() takes everything it needs as arguments, so it has no clock or radio of its
+    own and tools/link_recovery can drive it through simulated outages.
+*/
+class LinkMonitor
+{
+public:
+    static const unsigned long RENEW_MS = 5000;
+    static const unsigned long BACKOFF_FIRST_MS = 250;
+    static const unsigned long BACKOFF_MAX_MS = 2000;
+    static const unsigned long DEFAULT_INTERVAL_MS = 100; // until the first interval has been measured
+    static const unsigned long INTERVAL_WINDOW_MS = 500;
+    static const uint8_t DEGRADED_INTERVALS = 5;
+    static const uint8_t LOST_INTERVALS = 40;
+    static const unsigned long DEGRADED_MIN_MS = 300;
+    static const unsigned long LOST_MIN_MS = 2000;
+
+    // packetCount: RT packets received so far (any counter that grows per packet); returns true when
+    // an RT register packet should go out now
+    bool update(unsigned long now, uint32_t packetCount, unsigned long lastPacketMs, bool wifiUp);
+
+    LinkState getState() const { return state; }
+    bool isConnected() const { return state == LINK_STREAMING || state == LINK_DEGRADED; }
+    unsigned long getConnectedSince() const { return connectedSince; } // 0 while not connected
+    unsigned long getIntervalMs() const { return intervalMs ? intervalMs : DEFAULT_INTERVAL_MS; }
+    uint32_t getRecoveries() const { return recoveries; }
+    unsigned long getLastRecoveryMs() const { return lastRecoveryMs; } // from detecting an outage to streaming again
+    static const char *stateName(LinkState state);
+
+private:
+    void enter(LinkState next, unsigned long now);
+    void measureInterval(unsigned long now, uint32_t newPackets);
+
+    LinkState state = LINK_PROBING;
+    bool wifiWasUp = false;
+    uint32_t seenPackets = 0;
+    unsigned long nextRegisterAt = 0;
+    unsigned long backoffMs = 0;
+    unsigned long intervalMs = 0;
+    unsigned long windowStart = 0;
+    uint32_t windowPackets = 0;
+    unsigned long connectedSince = 0;
+    unsigned long outageStart = 0; // 0 while streaming or before the first connection
+    uint32_t recoveries = 0;
+    unsigned long lastRecoveryMs = 0;
+};
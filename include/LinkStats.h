@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+
+// Counters since boot; read from another task they may be a packet apart from each other
+struct LinkCounters
+{
+    static const uint8_t JITTER_BINS = 8;
+
+    uint32_t received = 0;   // RT packets seen
+    uint32_t accepted = 0;   // published to the display
+    uint32_t lost = 0;       // frame numbers skipped over
+    uint32_t gaps = 0;       // arrivals that skipped at least one frame
+    uint32_t duplicates = 0; // same frame number as the newest one
+    uint32_t reordered = 0;  // older than the newest frame, dropped
+    uint32_t resyncs = 0;    // counter jumped too far to be loss (Voicemeeter restart, long outage)
+    uint32_t jitterUs = 0;   // smoothed inter-arrival variation, RFC 3550 style
+    uint32_t maxIntervalUs = 0;
+    uint32_t intervalHistogram[JITTER_BINS] = {0}; // inter-arrival time, bin n < (4 ms << n), last bin open
+};
+
+/*
+    Loss, reordering and jitter tracking for the RT stream, keyed on the VBAN frame counter
+    (nuFrame, which is also tagVBAN_VMRT_PACKET::frameCounter).
+
+    check() classifies each arrival against the newest frame accepted so far. Only newer
+    frames are accepted; duplicates and late arrivals are dropped so they cannot overwrite
+    newer mixer state. A jump of more than RESYNC_FRAMES either way, or STALE_RUN_RESYNC
+    late frames in a row, is taken as a new stream rather than loss or reordering,
+    because Voicemeeter restarts its counter from zero.
+
+    Written by the UDP task only.
+*/
+class LinkStats
+{
+public:
+    static const uint32_t RESYNC_FRAMES = 1000;
+    static const uint8_t STALE_RUN_RESYNC = 8;
+    static const uint32_t FIRST_BIN_US = 4000;
+
+    enum Verdict
+    {
+        ACCEPT,
+        DUPLICATE,
+        STALE
+    };
+
+    Verdict check(uint32_t frame, uint32_t nowUs);
+    const LinkCounters &getCounters() const { return counters; }
+
+private:
+    void recordInterval(uint32_t nowUs);
+
+    LinkCounters counters;
+    bool haveFrame = false;
+    uint32_t newestFrame = 0;
+    uint8_t staleRun = 0; // consecutive late arrivals
+    uint32_t lastArrivalUs = 0;
+    uint32_t lastIntervalUs = 0;
+    uint32_t jitterScaled = 0; // jitter * 16, so the 1/16 smoothing stays in integers
+};
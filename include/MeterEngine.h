@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+// Level meter timing, all in integer milliseconds and dB * 100
+struct MeterBallistics
+{
+    uint16_t attackMs;             // time constant towards a higher level (0 = instant)
+    uint16_t releaseMs;            // exponential fall time constant, used when releaseDb100PerSec is 0
+    uint16_t releaseDb100PerSec;   // linear fall rate (PPM style)
+    uint16_t peakHoldMs;           // how long the peak marker stays put
+    uint16_t peakDecayDb100PerSec; // marker fall rate once the hold ran out
+};
+
+// VU: 300 ms integration both ways. PPM (IEC 60268-10 type II): 10 ms attack, 24 dB fall in 2.8 s.
+static const MeterBallistics METER_BALLISTICS_VU = {300, 300, 0, 1500, 2000};
+static const MeterBallistics METER_BALLISTICS_PPM = {10, 0, 860, 1500, 860};
+
+static const uint8_t METER_CHANNELS = 34;       // inputLeveldB100 channels of the RT packet
+static const int16_t METER_FLOOR_DB100 = -6000; // meters draw empty below this
+
+/*
+    Highest level per channel since the display last looked, fed once per RT packet.
+
+    Written by the UDP task, drained by the display task; a packet-rate peak that falls
+    between two rendered frames still reaches the meter.
+*/
+class MeterPeakCapture
+{
+public:
+    MeterPeakCapture();
+    void capture(const int16_t *levelsDb100); // METER_CHANNELS values from one packet
+
+    // Max since the previous take, or the latest level if no packet arrived in between
+    int16_t take(uint8_t channel);
+
+private:
+    static const int16_t NO_PEAK = INT16_MIN;
+    std::atomic<int16_t> peak[METER_CHANNELS];
+    std::atomic<int16_t> latest[METER_CHANNELS];
+};
+
+/*
+    Attack/release ballistics and peak hold, advanced once per rendered frame.
+
+    Integer only: the exponential approach uses k = dt / (tau + dt) in Q15, which
+    is close enough to 1 - exp(-dt / tau) at frame-sized steps.
+*/
+class MeterEngine
+{
+public:
+    explicit MeterEngine(const MeterBallistics &ballistics = METER_BALLISTICS_PPM);
+    void setBallistics(const MeterBallistics &b) { ballistics = b; }
+    // Bit c set: channel c is animated and counts towards isSettled(); the others are not read at all
+    void setChannels(uint64_t mask) { channelMask = mask; }
+
+    void update(MeterPeakCapture &source, unsigned long nowMs);
+
+    int16_t level(uint8_t channel) const { return levels[channel].level; }
+    int16_t peak(uint8_t channel) const { return levels[channel].peak; }
+    bool isSettled() const { return settled; } // nothing left to animate
+
+private:
+    struct ChannelState
+    {
+        int16_t level = METER_FLOOR_DB100;
+        int16_t peak = METER_FLOOR_DB100;
+        unsigned long peakTime = 0;
+    };
+
+    static int32_t approach(int32_t value, int32_t target, uint32_t dtMs, uint16_t tauMs);
+    static int32_t fall(int32_t value, int32_t floor, uint32_t dtMs, uint16_t db100PerSec);
+
+    MeterBallistics ballistics;
+    ChannelState levels[METER_CHANNELS];
+    unsigned long lastUpdate = 0;
+    uint64_t channelMask = (1ull << METER_CHANNELS) - 1;
+    bool settled = true;
+};
@@ -2,9 +2,19 @@
 #include <Arduino.h>
 #include <WiFiManager.h>
 #include <WiFi.h>
-#include <AsyncUDP.h>
 #include <Preferences.h>
 #include "VoicemeeterProtocol.h"
+#include "VBANCodec.h"
+#include "VBANSocket.h"
+#include "VBANCommandBuilder.h"
+#include "GainAccumulator.h"
+#include "MeterEngine.h"
+#include <atomic>
+#include "TripleBuffer.h"
+#include "StripMap.h"
+#include "LinkStats.h"
+#include "RTPacketDelta.h"
+#include "LinkMonitor.h"
 
 enum NetworkCommandType
 {
@@ -25,14 +35,26 @@ public:
     void setupStores();
     bool begin();
     void update();
-    bool isConnected() const { return connected; }
-    const tagVBAN_VMRT_PACKET &getCurrentPacket() const { return currentRTPPacket; }
+    bool isConnected() const { return linkMonitor.isConnected(); }
+    TripleBuffer<RTSnapshot> &getPacketBuffer() { return rtPacketBuffer; }
+    MeterPeakCapture &getMeterPeaks() { return meterPeaks; }
+    LinkCounters getLinkCounters() const { return linkStats.getCounters(); }
+    const VBANSocket &getSocket() const { return udp; }
+    const LinkMonitor &getLinkMonitor() const { return linkMonitor; }
+    void setStripMap(const StripMap *map) { stripMap = map; }
+    // Commands are batched into one VBAN-TEXT datagram until flushCommands(), called once per loop
     void sendCommand(const NetworkCommand &command);
+    void flushCommands();
+    uint32_t getCommandStatements() const { return commandStatements; }
+    uint32_t getCommandDatagrams() const { return commandDatagrams; }
+    // channel is a strip map slot (the selected ring)
     void incrementVolume(uint8_t channel, bool up);
-    void incrementVolume(uint8_t channel, float level);
+    int16_t incrementVolume(uint8_t channel, float level); // returns the gain (dB * 100) the strip is heading to
     unsigned long getLastPacketTime() const { return lastPacketTime; }
-    unsigned long getConectionStartTime() const { return connectionStartTime; }
+    unsigned long getConectionStartTime() const { return linkMonitor.getConnectedSince(); }
     char getDestIP();
+    // Called from the UDP task when an RT packet changes something the display shows
+    void setVisibleChangeCallback(void (*callback)()) { visibleChangeCallback = callback; }
     uint32_t getDeviceIP();
 
 private:
@@ -40,17 +62,38 @@ private:
     IPAddress DEST_IP;
     WiFiManager wifiManager;
     Preferences preferences;
-    AsyncUDP udp;
-    bool connected;
+    VBANSocket udp;
+    LinkMonitor linkMonitor; // connection state and RT re-registration, loop task only
     unsigned long lastPacketTime;
-    unsigned long lastRTPRequestTime;
-    unsigned long connectionStartTime;
-    tagVBAN_VMRT_PACKET currentRTPPacket;
+    TripleBuffer<RTSnapshot> rtPacketBuffer; // written by the UDP task, read in place by the display task
+    RTPacketIngest rtIngest;                  // copies only the packet regions that changed
+    MeterPeakCapture meterPeaks;                      // per-packet level peaks, so none are lost between frames
+    LinkStats linkStats;                              // RT stream loss/reorder/jitter, drops stale frames
     uint8_t commandFrameCounter;
     bool ipAddressNotSaved;
+    VBANTextPacket textPacket; // open command batch, reused for every datagram, only touched from loop()
+    uint32_t commandStatements; // ';'-separated statements in datagrams writeTo() accepted in full
+    uint32_t commandDatagrams;
+    uint32_t pendingStatements; // in textPacket, not sent yet
+    GainAccumulator gainAccumulator;
+    const StripMap *stripMap;
+    std::atomic<int16_t> reportedStripGain[GainAccumulator::NUM_STRIPS]; // from the latest RT packet, written by the UDP task
 
-    std::vector<uint8_t> createCommandPacket(const String &command);
-    std::vector<uint8_t> createRTPPacket();
-    void handleUDPPacket(AsyncUDPPacket packet);
-    void sendVBANCommand(const String &command);
+    static const unsigned long GAIN_FLUSH_INTERVAL_MS = 100;
+    static const int16_t LEVEL_CHANGE_THRESHOLD_DB100 = 25; // meter movement below this is not worth a frame
+    static const int16_t LEVEL_FLOOR_DB100 = -6000;          // meters draw empty below this
+
+    // What the display was last told about, compared against each incoming packet (UDP task only).
+    // Only fields something on screen draws: every strip's routing, and the mapped strips' gains and level channels.
+    void (*visibleChangeCallback)() = nullptr;
+    uint32_t notifiedStripState[8];
+    int16_t notifiedGain[STRIP_MAP_SLOTS];
+    int16_t notifiedLevel[STRIP_MAP_SLOTS * 2]; // left, right per slot
+
+    void sendRTPRegister();
+    static void onRTPacket(void *context, const VBANPacketView &packet);
+    void handleRTPacket(const VBANPacketView &view);
+    void sendVBANCommand(const char *command);
+    void flushGainChanges();
+    bool visibleFieldsChanged(const tagVBAN_VMRT_PACKET &packet, uint8_t changedRegions);
 };
\ No newline at end of file
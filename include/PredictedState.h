@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include "VoicemeeterProtocol.h"
+
+/*
+    Optimistic view of the mixer state the display renders.
+
+    Outgoing gain and routing commands are applied here as soon as they are issued,
+    so the UI does not wait a network round trip. Each prediction remembers the RT
+    frame that was current when it was made; a later frame showing the predicted
+    value confirms it, and one that still disagrees after GRACE_FRAMES (or TIMEOUT_MS
+    without any newer frame) rolls the prediction back to what Voicemeeter reports.
+
+    Single-threaded: owned by the display task.
+*/
+class PredictedState
+{
+public:
+    static const uint8_t NUM_STRIPS = 8;
+    static const uint32_t GRACE_FRAMES = 8;
+    static const unsigned long TIMEOUT_MS = 1000;
+
+    // strip is Voicemeeter's 0-based strip index; reported gains are read with vmrtStripGain()
+    void predictGain(uint8_t strip, int16_t gainDb100, uint32_t currentFrame, unsigned long now);
+    void predictRouting(uint8_t strip, uint32_t stateMask, bool enabled, uint32_t currentFrame, unsigned long now);
+
+    // Confirm or roll back in-flight predictions against the latest RT packet
+    void reconcile(const tagVBAN_VMRT_PACKET &packet, unsigned long now);
+
+    int16_t stripGain(const tagVBAN_VMRT_PACKET &packet, uint8_t strip) const;
+    uint32_t stripState(const tagVBAN_VMRT_PACKET &packet, uint8_t strip) const;
+    uint8_t inFlightCount() const;
+    uint32_t getRollbackCount() const { return rollbacks; }
+    uint32_t getRoutingRevision() const { return routingRevision; } // bumped whenever predictions change what stripState() returns
+
+private:
+    struct PendingGain
+    {
+        bool active = false;
+        int16_t value = 0;
+        uint32_t issuedFrame = 0;
+        unsigned long issuedTime = 0;
+    };
+    struct PendingRouting
+    {
+        uint32_t mask = 0;  // state bits with a prediction in flight
+        uint32_t value = 0; // predicted value of those bits
+        uint32_t issuedFrame = 0;
+        unsigned long issuedTime = 0;
+    };
+
+    // true when the prediction should be dropped because Voicemeeter had long enough to apply it
+    static bool expired(uint32_t issuedFrame, unsigned long issuedTime, uint32_t frame, unsigned long now);
+
+    PendingGain gains[NUM_STRIPS];
+    PendingRouting routing[NUM_STRIPS];
+    uint32_t rollbacks = 0;
+    uint32_t routingRevision = 0;
+};
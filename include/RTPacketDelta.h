@@ -0,0 +1,51 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "VoicemeeterProtocol.h"
+#include "VBANCodec.h"
+
+// Regions of tagVBAN_VMRT_PACKET tracked for changes; all start and end on a 4-byte boundary
+enum RTRegion : uint8_t
+{
+    RT_REGION_HEADER, // VBAN header, frame counter, type/version/samplerate: changes every packet
+    RT_REGION_LEVELS, // inputLeveldB100, outputLeveldB100
+    RT_REGION_STATE,  // TransportBit, stripState, busState
+    RT_REGION_GAINS,  // strip gain layers, busGaindB100
+    RT_REGION_LABELS, // stripLabelUTF8c60, busLabelUTF8c60
+    RT_REGION_COUNT
+};
+
+#define RT_CHANGED(region) (1 << (region))
+
+// A published RT packet plus, per region, the ingest sequence of its last change.
+// A consumer that remembers the stamps it last acted on can skip regions whose stamp is unchanged,
+// however many packets were published in between.
+struct RTSnapshot
+{
+    tagVBAN_VMRT_PACKET packet;
+    uint32_t regionStamp[RT_REGION_COUNT];
+};
+
+/*
+    Producer side of delta-only RT ingest (UDP task).
+
+    Each region of the incoming packet is compared word by word against the snapshot
+    published last; changed regions get a new stamp. The slot being written is then
+    brought up to date by copying only the regions that changed or that the slot
+    missed while it was out of rotation, so a packet where only the meters moved
+    copies 196 bytes instead of 1412.
+*/
+class RTPacketIngest
+{
+public:
+    // view must hold a valid RT packet; latest is the previously published snapshot, or nullptr.
+    // Returns a RT_CHANGED() bitmap relative to latest.
+    uint8_t ingest(const VBANPacketView &view, RTSnapshot &slot, const RTSnapshot *latest);
+
+    static size_t regionOffset(uint8_t region);
+    static size_t regionSize(uint8_t region) { return regionOffset(region + 1) - regionOffset(region); }
+
+private:
+    uint32_t sequence = 0;
+    uint32_t stamps[RT_REGION_COUNT] = {0};
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <lvgl.h>
+
+// Anti-aliased coverage of one ring, for the |dx|, |dy| >= 0 quadrant around the centre
+struct RingMask
+{
+    int16_t radius;       // outer edge, as passed to lv_draw_arc
+    int16_t width;        // towards the centre
+    uint16_t *rowOffset;  // radius + 1 entries: start of row |dy| in coverage
+    uint8_t *rowFirst;    // first |dx| with coverage on row |dy|
+    uint8_t *rowLength;   // covered pixels on row |dy|
+    uint8_t *coverage;    // 0..255
+};
+
+/*
+    Pre-rasterized rings for the Monitor arcs.
+
+    The Monitor arcs never change size, so the anti-aliased ring edges are computed
+    once per radius/width pair when an arc is attached, instead of on every redraw.
+    An attached arc is drawn by its own LV_EVENT_DRAW_MAIN handler: LVGL's arc drawing
+    is muted (arc opa 0) and both parts are blended straight into the RGB565 draw
+    buffer from the cached quadrant, cut to the current angles with two half-plane
+    tests. The angle and rotation (arcOffsetAngle style offsets included) are applied
+    at draw time, so one ring serves every value.
+
+    Writing into the layer buffer from the event relies on draw tasks running
+    synchronously (LV_OS_NONE, one software draw unit) and on the layer layout of LVGL
+    9.4, the version platformio.ini pins; other versions and configurations, and
+    layers that are not RGB565 or have no buffer yet, fall back to lv_draw_arc.
+*/
+class RingMaskCache
+{
+public:
+    static const uint8_t MAX_RINGS = 12;
+    static const uint8_t MAX_ARCS = 16;
+
+    // Takes over drawing of an lv_arc; false when the ring or arc table is full
+    static bool attach(lv_obj_t *arc);
+    // Forgets every attached arc and frees the rings, for lv_deinit()
+    static void reset();
+    // Sweeps blended from the cache; the rest went to lv_draw_arc
+    static uint32_t getCachedSweeps() { return cachedSweeps; }
+
+private:
+    struct AttachedArc
+    {
+        const RingMask *main; // nullptr if the background ring has no width
+        const RingMask *indicator;
+        lv_opa_t mainOpa;
+        lv_opa_t indicatorOpa;
+    };
+
+    static const RingMask *findOrBuild(int32_t radius, int32_t width);
+    static void drawEvent(lv_event_t *e);
+    static void drawSweep(lv_layer_t *layer, const RingMask &ring, lv_point_t center, int32_t startAngle, int32_t endAngle,
+                          lv_color_t color, lv_opa_t opa);
+    static void fillSweep(lv_layer_t *layer, const RingMask &ring, lv_point_t center, int32_t startAngle, int32_t endAngle,
+                          lv_color_t color, lv_opa_t opa);
+
+    static RingMask rings[MAX_RINGS];
+    static uint8_t ringCount;
+    static AttachedArc arcs[MAX_ARCS];
+    static uint8_t arcCount;
+    static uint32_t cachedSweeps;
+};
@@ -2,6 +2,17 @@
 #include <Arduino.h>
 #include <MLX90393.h>
 #include <Wire.h>
+#include <atomic>
+#include "FixedAngle.h"
+#include "KnobFilter.h"
+#include "SpscRing.h"
+
+// One magnetometer reading, timestamped when the sensor task read it
+struct RotationSample
+{
+    uint32_t timestampUs;
+    angle_q15_t angle; // Q15 half turns, see FixedAngle.h
+};
 
 class MLX90393_Configurable : public MLX90393
 {
@@ -85,24 +96,37 @@ class RotationManager
 public:
     RotationManager();
     void begin();
-    float update();
+    float update(); // drains queued samples; returns the gain change (dB) since the last call
+    void setKnobFilterConfig(const KnobFilterConfig &config) { knobFilter.setConfig(config); }
     long getLastRotationTime() { return lastRotationTime; }
     void deepSleep();
     void enterWakeOnChangeMode();
     bool isInitialized() const { return initialized; }
+    uint32_t getDroppedSampleCount() const { return droppedSamples.load(std::memory_order_relaxed); }
 
 private:
-    static constexpr float ANGLE_DEADBAND = 3.0f; // degrees
+    static const UBaseType_t SENSOR_TASK_PRIORITY = 5; // above the display (2) and loop (1) tasks
+    static const BaseType_t SENSOR_TASK_CORE = 0;
 
     MLX90393_Configurable mlx;
     MLX90393ArduinoHal arduinoHal;
-    float lastAngle;
+    angle_q15_t lastAngle;
+    KnobFilter knobFilter;
     long lastRotationTime;
     bool initialized = false;
     static const int INT_PIN = 10; // (INT pin on MLX90393)
-    volatile bool dataReady;
     short numStartupSamples = 0;
 
+    // Sensor task -> control loop handoff
+    TaskHandle_t sensorTaskHandle = nullptr;
+    SpscRing<RotationSample, 32> samples;
+    std::atomic<bool> sampling{false}; // cleared before the loop reconfigures the sensor
+    SemaphoreHandle_t busMutex = nullptr; // held by the sensor task around each Wire1 read
+    std::atomic<uint32_t> droppedSamples{0};
+
     static void IRAM_ATTR dataReadyISR();
+    static void sensorTask(void *pv);
+    void readSample();
+    void stopSampling();
     void configureInterrupt(uint8_t intPin);
 };
\ No newline at end of file
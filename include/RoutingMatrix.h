@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+
+/*
+    Paged view of the full Potato routing matrix: 8 strips by 8 buses (A1..A5, B1..B3).
+
+    The Output Matrix screen only has a POOL_COLUMNS x POOL_ROWS grid of buttons. The
+    matrix scrolls a window of that size over the strips (columns) and buses (rows), and
+    the same buttons are rebound to whichever cells the window covers, so object count
+    and RAM stay fixed no matter how large the matrix is. Windows step by a full page
+    and clamp at the far edge instead of leaving empty cells, so the last pages overlap.
+
+    Routing is kept as one byte per strip, bit n = bus n. applyRouting() XORs it against
+    what the buttons currently show and returns the pool cells that need touching.
+
+    Single-threaded: owned by the display task.
+*/
+class RoutingMatrix
+{
+public:
+    static const uint8_t NUM_STRIPS = 8;
+    static const uint8_t NUM_BUSES = 8;
+    static const uint8_t POOL_COLUMNS = 3;
+    static const uint8_t POOL_ROWS = 3;
+    static const uint8_t POOL_SIZE = POOL_COLUMNS * POOL_ROWS; // button index = column * POOL_ROWS + row
+
+    explicit RoutingMatrix(uint8_t firstStrip = 0);
+
+    // Page by one window; return true when the window moved
+    bool scrollStrips(int8_t pages);
+    bool scrollBuses(int8_t pages); // wraps around
+
+    uint8_t firstStrip() const { return stripOffset; }
+    uint8_t firstBus() const { return busOffset; }
+    uint8_t cellStrip(uint8_t cell) const { return stripOffset + cell / POOL_ROWS; }
+    uint8_t cellBus(uint8_t cell) const { return busOffset + cell % POOL_ROWS; }
+
+    // routing[s] = routingBits(stripState of strip s); returns a bit per pool cell whose state changed
+    uint16_t applyRouting(const uint8_t routing[NUM_STRIPS]);
+    bool cellEnabled(uint8_t cell) const { return shown & (1 << cell); }
+    void invalidate() { shownValid = false; } // the buttons were redrawn by someone else
+    bool isBound() const { return shownValid; } // false until the current page has been applied
+
+    static uint8_t routingBits(uint32_t stripState);
+    static const char *busName(uint8_t bus);
+
+private:
+    static uint8_t clampOffset(int offset, uint8_t count, uint8_t window);
+    static uint8_t pageOf(uint8_t offset, uint8_t window);
+
+    uint8_t stripOffset;
+    uint8_t busOffset = 0;
+    uint16_t shown = 0;      // pool cell states the buttons display
+    bool shownValid = false; // false after a page change: every cell is rebound
+};
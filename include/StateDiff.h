@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+
+// Which strip button bits flipped since the last update(); bit s of strips = stripState[s] changed
+struct StateChanges
+{
+    static const uint8_t NUM_CHANNELS = 8;
+
+    uint8_t strips = 0;
+    uint32_t stripBits[NUM_CHANNELS] = {0}; // stripState XOR the applied snapshot
+
+    bool any() const { return strips; }
+    bool stripChanged(uint8_t strip, uint32_t mask) const { return stripBits[strip] & mask; }
+};
+
+/*
+    XOR diff of the RT packet's stripState[8] against the snapshot a UI consumer last
+    applied. Each consumer (Monitor preview, Output Matrix) owns one, so a screen that
+    was not visible still sees everything that changed once it is shown again. The first
+    update() after construction or reset() reports every bit as changed. busState is not
+    tracked: nothing on screen draws the bus buttons.
+
+    Single-threaded: owned by the display task.
+*/
+class StateDiff
+{
+public:
+    const StateChanges &update(const uint32_t stripState[StateChanges::NUM_CHANNELS]);
+    void reset() { primed = false; }
+
+private:
+    uint32_t appliedStrips[StateChanges::NUM_CHANNELS] = {0};
+    bool primed = false;
+    StateChanges changes;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+
+static const uint8_t STRIP_MAP_SLOTS = 3; // rings on the Monitor screen, rows of the output grid
+static const uint8_t STRIP_MAP_BUSES = 3; // output grid columns per row
+
+// One stored slot: 3 bytes in preferences
+struct StripMapEntry
+{
+    uint8_t strip;        // Voicemeeter strip index, 0..7
+    uint8_t levelChannel; // inputLeveldB100 index of the left channel; the right one follows it
+    uint8_t busMask;      // buses offered in the grid: bit n = bus n (0..4 = A1..A5, 5..7 = B1..B3), lowest STRIP_MAP_BUSES used
+};
+
+/*
+    Which Voicemeeter Potato strips, level channels and buses the UI controls.
+
+    The table lives in the "stripmap" preferences namespace and is resolved once, in
+    begin(), into the flat per-slot arrays below; the render and command paths index
+    those directly instead of deriving indices per frame. Missing or invalid slots fall
+    back to the virtual inputs 5, 6 and 7 on A1..A3, the layout the firmware always had.
+    store() only updates the stored table (kept in memory as well, so several stores
+    before a restart add up); the new mapping is used after the next restart, so the
+    display and network tasks never see the resolved table change under them.
+*/
+class StripMap
+{
+public:
+    StripMap(); // resolved defaults, usable before begin()
+    void begin();
+    bool store(uint8_t slot, const StripMapEntry &entry);
+    StripMapEntry getEntry(uint8_t slot) const;       // in use since begin()
+    StripMapEntry getStoredEntry(uint8_t slot) const; // in preferences, used from the next restart
+
+    static const StripMap &defaults(); // what the managers use until they are given a loaded map
+    static StripMapEntry defaultEntry(uint8_t slot);
+    static uint8_t firstLevelChannel(uint8_t strip); // 5 stereo hardware strips, then 8-channel virtual strips
+    static uint32_t busStateBit(uint8_t bus);        // stripState bit for Strip[n].A1..B3
+
+    // Resolved table, indexed by slot
+    uint8_t strip[STRIP_MAP_SLOTS];
+    uint8_t levelLeft[STRIP_MAP_SLOTS];
+    uint8_t levelRight[STRIP_MAP_SLOTS];
+    uint8_t bus[STRIP_MAP_SLOTS][STRIP_MAP_BUSES];     // bus index for commands
+    uint32_t busBit[STRIP_MAP_SLOTS][STRIP_MAP_BUSES]; // matching stripState bit
+
+private:
+    static const uint8_t NUM_STRIPS = 8;
+    static const uint8_t NUM_LEVEL_CHANNELS = 34;
+
+    static bool isValid(const StripMapEntry &entry);
+    void resolve(uint8_t slot, const StripMapEntry &entry);
+
+    Preferences preferences;
+    StripMapEntry entries[STRIP_MAP_SLOTS]; // resolved in begin()
+    StripMapEntry stored[STRIP_MAP_SLOTS];  // what preferences hold, including stores since begin()
+};
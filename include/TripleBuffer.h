@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+/*
+    Lock-free single producer / single consumer snapshot buffer.
+
+    The producer (UDP receive callback) fills the buffer returned by beginWrite() and then
+    calls publish(). The consumer (display task) calls acquire() once per frame and
+    reads the returned snapshot in place; that snapshot is owned by the consumer
+    until its next acquire(), so the producer can never tear it.
+
+    Three slots rotate between the roles back (producer), middle (latest published)
+    and front (consumer). Only the middle index is shared, so a single atomic
+    exchange on each side is all the synchronisation needed.
+*/
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() : buffers(), middle(1), backIndex(0), publishedIndex(NONE), frontIndex(2), publishCount(0) {}
+
+    // Producer side: slot to fill before calling publish()
+    T *beginWrite() { return &buffers[backIndex]; }
+
+    // Producer side: make the slot filled since the last publish() visible to the consumer
+    void publish()
+    {
+        publishedIndex = backIndex;
+        uint8_t previous = middle.exchange(backIndex | FRESH_BIT, std::memory_order_acq_rel);
+        backIndex = previous & INDEX_MASK;
+        publishCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Producer side: the slot published last, or nullptr before the first publish(). The consumer
+    // may be reading it at the same time, which is fine: only the producer ever writes a slot.
+    const T *lastPublished() const { return publishedIndex == NONE ? nullptr : &buffers[publishedIndex]; }
+
+    // Consumer side: latest published snapshot, valid until the next acquire().
+    // isNew is set when the snapshot differs from the one returned last time.
+    const T *acquire(bool *isNew = nullptr)
+    {
+        bool fresh = middle.load(std::memory_order_relaxed) & FRESH_BIT;
+        if (fresh)
+        {
+            uint8_t previous = middle.exchange(frontIndex, std::memory_order_acq_rel);
+            frontIndex = previous & INDEX_MASK;
+        }
+        if (isNew)
+            *isNew = fresh;
+        return &buffers[frontIndex];
+    }
+
+    // Consumer side: snapshot returned by the last acquire()
+    const T *current() const { return &buffers[frontIndex]; }
+
+    uint32_t getPublishCount() const { return publishCount.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x03;
+    static constexpr uint8_t FRESH_BIT = 0x04;
+    static constexpr uint8_t NONE = 0xFF;
+
+    T buffers[3];
+    std::atomic<uint8_t> middle; // index of the latest published slot, plus FRESH_BIT until consumed
+    uint8_t backIndex;           // producer owned
+    uint8_t publishedIndex;      // producer owned
+    uint8_t frontIndex;          // consumer owned
+    std::atomic<uint32_t> publishCount;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "VoicemeeterProtocol.h"
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "VBAN is little-endian; the codec reads fields in native byte order"
+#endif
+
+#define VBAN_MAGIC 0x4E414256 // 'V' 'B' 'A' 'N' read as a little-endian uint32_t
+
+/*
+    Zero-copy view over a raw VBAN datagram.
+
+    Fields are read straight out of the UDP buffer at their documented offsets,
+    so validating a packet touches a handful of bytes instead of copying it.
+    Reads go through memcpy, which keeps them legal for unaligned pbuf payloads
+    and compiles down to a plain load on both the ESP32 and the host.
+*/
+class VBANPacketView
+{
+public:
+    VBANPacketView(const uint8_t *data, size_t length) : data(data), length(length) {}
+
+    bool isVBAN() const { return length >= sizeof(tagVBAN_HEADER) && read<uint32_t>(offsetof(tagVBAN_HEADER, vban)) == VBAN_MAGIC; }
+    uint8_t protocol() const { return data[offsetof(tagVBAN_HEADER, format_SR)] & VBAN_PROTOCOL_MASK; }
+    uint8_t serviceType() const { return data[offsetof(tagVBAN_HEADER, format_nbc)]; }
+    uint32_t frameNumber() const { return read<uint32_t>(offsetof(tagVBAN_HEADER, nuFrame)); }
+    size_t size() const { return length; }
+    const uint8_t *raw() const { return data; }
+
+    bool isRTPacket() const
+    {
+        return isVBAN() && protocol() == VBAN_PROTOCOL_SERVICE && serviceType() == VBAN_SERVICE_RTPACKET &&
+               length >= sizeof(tagVBAN_VMRT_PACKET);
+    }
+
+    // Typed accessors, only valid once isRTPacket() has returned true
+    int16_t inputLevel(uint8_t channel) const { return read<int16_t>(offsetof(tagVBAN_VMRT_PACKET, inputLeveldB100) + channel * sizeof(int16_t)); }
+    int16_t outputLevel(uint8_t channel) const { return read<int16_t>(offsetof(tagVBAN_VMRT_PACKET, outputLeveldB100) + channel * sizeof(int16_t)); }
+    int16_t stripGain(uint8_t strip) const { return read<int16_t>(offsetof(tagVBAN_VMRT_PACKET, stripGaindB100Layer1) + VMRT_STRIP_GAIN_INDEX(strip) * sizeof(int16_t)); } // same slot as vmrtStripGain
+    int16_t busGain(uint8_t bus) const { return read<int16_t>(offsetof(tagVBAN_VMRT_PACKET, busGaindB100) + bus * sizeof(int16_t)); }
+    uint32_t stripState(uint8_t strip) const { return read<uint32_t>(offsetof(tagVBAN_VMRT_PACKET, stripState) + strip * sizeof(uint32_t)); }
+    uint32_t busState(uint8_t bus) const { return read<uint32_t>(offsetof(tagVBAN_VMRT_PACKET, busState) + bus * sizeof(uint32_t)); }
+
+    // Decode the whole RT packet into a snapshot slot
+    bool copyRTPacket(tagVBAN_VMRT_PACKET *destination) const
+    {
+        if (!isRTPacket())
+            return false;
+        memcpy(destination, data, sizeof(tagVBAN_VMRT_PACKET));
+        return true;
+    }
+
+private:
+    template <typename T>
+    T read(size_t offset) const
+    {
+        T value;
+        memcpy(&value, data + offset, sizeof(T));
+        return value;
+    }
+
+    const uint8_t *data;
+    size_t length;
+};
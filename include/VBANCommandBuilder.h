@@ -0,0 +1,91 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "VoicemeeterProtocol.h"
+
+#define VBAN_HEADER_SIZE 28
+#define VBAN_TEXT_MAX_PAYLOAD 1436 // VBAN_DATA_MAX_SIZE, keeps a datagram under the Ethernet MTU
+#define VBAN_TEXT_STREAM_NAME "Command1"
+
+// Register for RT packets: service 32, 15 s timeout, stream "Register RTP". Constant, so it lives in flash.
+static constexpr uint8_t VBAN_RT_REGISTER_PACKET[VBAN_HEADER_SIZE] = {
+    0x56, 0x42, 0x41, 0x4e, VBAN_PROTOCOL_SERVICE, 0x00, VBAN_SERVICE_RTPACKETREGISTER, 0x0f,
+    0x52, 0x65, 0x67, 0x69, 0x73, 0x74, 0x65, 0x72, 0x20, 0x52, 0x54, 0x50, 0x01, 0x59, 0x41, 0,
+    0, 0, 0, 154};
+
+/*
+    Fixed-capacity formatter for the Voicemeeter command grammar.
+
+    Writes into a caller-supplied buffer and never allocates; numbers are formatted
+    with integer arithmetic rather than printf so no float conversion buffers are
+    touched either. Output that does not fit is dropped and overflowed() is set.
+*/
+class VBANCommandWriter
+{
+public:
+    VBANCommandWriter(char *buffer, size_t capacity);
+
+    VBANCommandWriter &text(const char *str);
+    VBANCommandWriter &character(char c);
+    VBANCommandWriter &integer(long value);
+    VBANCommandWriter &fixed2(float value); // value with exactly two decimals, e.g. -1.25
+
+    // Grammar helpers; indices are Voicemeeter's 0-based strip/bus numbers
+    VBANCommandWriter &stripGainIncrement(uint8_t strip, float db);  // strip(5).gain += 1.25
+    VBANCommandWriter &stripGainStep(uint8_t strip, bool up, int db); // strip(5).gain -= 3
+    VBANCommandWriter &stripGain(uint8_t strip, float db);           // Strip[5].Gain = -3.00
+    VBANCommandWriter &stripBus(uint8_t strip, uint8_t bus, bool enabled); // Strip[5].A1 = 1, bus 0-4 = A1-A5, 5-7 = B1-B3
+    VBANCommandWriter &separator() { return text("; "); }
+
+    const char *c_str() const { return buffer; }
+    size_t length() const { return used; }
+    size_t capacity() const { return size - 1; }
+    bool overflowed() const { return overflow; }
+    void clear();
+
+private:
+    char *buffer;
+    size_t size;
+    size_t used;
+    bool overflow;
+};
+
+// A VBANCommandWriter with its own storage, for building one statement on the stack
+template <size_t N>
+class VBANCommandString : public VBANCommandWriter
+{
+public:
+    VBANCommandString() : VBANCommandWriter(storage, N) {}
+
+private:
+    char storage[N];
+};
+
+/*
+    VBAN-TEXT datagram in a fixed buffer: 28-byte header addressed to the
+    "Command1" stream, followed by the command text.
+
+    Voicemeeter runs every "; "-separated statement in a datagram in order, so
+    append() packs whole statements until the payload is full.
+*/
+class VBANTextPacket
+{
+public:
+    VBANTextPacket();
+
+    // Starts a new datagram, reusing the buffer
+    VBANCommandWriter &begin(uint8_t frameCounter);
+    VBANCommandWriter &command() { return writer; }
+
+    // Adds one statement (or a "; " list of them) after those already in the datagram.
+    // Returns false and leaves the datagram untouched when it does not fit.
+    bool append(const char *statement);
+    bool empty() const { return writer.length() == 0; }
+
+    const uint8_t *data() const { return packet; }
+    size_t size() const { return VBAN_HEADER_SIZE + writer.length(); }
+
+private:
+    uint8_t packet[VBAN_HEADER_SIZE + VBAN_TEXT_MAX_PAYLOAD + 1]; // +1 for the writer's terminator, not sent
+    VBANCommandWriter writer;
+};
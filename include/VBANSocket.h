@@ -0,0 +1,42 @@
+#pragma once
+#include <Arduino.h>
+#include <lwip/udp.h>
+#include "VBANCodec.h"
+
+/*
+    Raw lwIP UDP endpoint for VBAN, replacing AsyncUDP on the receive side.
+
+    AsyncUDP hands every datagram to its own task through a queue entry it mallocs, and
+    the onPacket handler then takes an AsyncUDPPacket (and its pbuf reference) by value.
+    Here the lwIP receive callback runs on the tcpip thread and checks the VBAN header
+    in the first pbuf in place; anything that is not an RT packet is freed untouched.
+    RT packets reach the handler as a view straight over the pbuf payload, so the
+    handler's copy into the publish buffer is the only copy. A chained pbuf is first
+    gathered into a fixed scratch buffer. Nothing on this path allocates.
+
+    Sends share the same pcb (Voicemeeter streams back to the register packet's source
+    port) and go through a PBUF_RAM pbuf; they are rare and stay on the loop task.
+*/
+class VBANSocket
+{
+public:
+    typedef void (*RTPacketHandler)(void *context, const VBANPacketView &packet); // runs on the tcpip thread
+
+    bool listen(uint16_t port, RTPacketHandler handler, void *context);
+    size_t writeTo(const uint8_t *data, size_t length, const IPAddress &address, uint16_t port);
+
+    uint32_t getDelivered() const { return delivered; }
+    uint32_t getRejected() const { return rejected; }
+    uint32_t getGathered() const { return gathered; }
+
+private:
+    static void receive(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port);
+
+    struct udp_pcb *pcb = nullptr;
+    RTPacketHandler handler = nullptr;
+    void *context = nullptr;
+    uint8_t scratch[sizeof(tagVBAN_VMRT_PACKET)]; // chained pbufs only, tcpip thread only
+    uint32_t delivered = 0; // RT packets handed to the handler
+    uint32_t rejected = 0;  // not VBAN RT, or too short
+    uint32_t gathered = 0;  // delivered from a pbuf chain via scratch
+};
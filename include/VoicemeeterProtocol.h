@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
-#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 /*
     VOICEMEETER POTATO STRIP/BUS INDEX ASSIGNMENT
@@ -26,57 +28,94 @@
 */
 
 // VOICEMEETER POTATO Protocol Definitions
+// Fixed-width fields so the layout is identical on the ESP32 and on a 64-bit host, see the static_asserts below.
 struct tagVBAN_VMRT_PACKET
 {
-    unsigned char magic[4]; // VBAN
-    unsigned char subProtocol;
-    unsigned char function;
-    unsigned char service;        // 32 = VBAN_SERVICE_RTPACKETREGISTER
-    unsigned char additionalInfo; //
-    unsigned char streamName[16]; // stream name
-    unsigned long frameCounter;
-    unsigned char voicemeeterType;    // 1 = Voicemeeter, 2= Voicemeeter Banana, 3 Potato
-    unsigned char reserved;           // unused
-    unsigned short buffersize;        // main stream buffer size
-    unsigned long voicemeeterVersion; // version like for VBVMR_GetVoicemeeterVersion() functino
-    unsigned long optionBits;         // unused
-    unsigned long samplerate;         // main stream samplerate
-    short inputLeveldB100[34];        // pre fader input peak level in dB * 100
-    short outputLeveldB100[64];       // bus output peak level in dB * 100
-    unsigned long TransportBit;       // Transport Status
-    unsigned long stripState[8];      // Strip Buttons Status
-    unsigned long busState[8];        // Bus Buttons Status
-    short stripGaindB100Layer1[8];    // Strip Gain in dB * 100
-    short stripGaindB100Layer2[8];
-    short stripGaindB100Layer3[8];
-    short stripGaindB100Layer4[8];
-    short stripGaindB100Layer5[8];
-    short stripGaindB100Layer6[8];
-    short stripGaindB100Layer7[8];
-    short stripGaindB100Layer8[8];
-    short busGaindB100[8];         // Bus Gain in dB * 100
+    uint8_t magic[4]; // VBAN
+    uint8_t subProtocol;
+    uint8_t function;
+    uint8_t service;        // 32 = VBAN_SERVICE_RTPACKETREGISTER
+    uint8_t additionalInfo; //
+    uint8_t streamName[16]; // stream name
+    uint32_t frameCounter;
+    uint8_t voicemeeterType;          // 1 = Voicemeeter, 2= Voicemeeter Banana, 3 Potato
+    uint8_t reserved;                 // unused
+    uint16_t buffersize;              // main stream buffer size
+    uint32_t voicemeeterVersion;      // version like for VBVMR_GetVoicemeeterVersion() functino
+    uint32_t optionBits;              // unused
+    uint32_t samplerate;              // main stream samplerate
+    int16_t inputLeveldB100[34];      // pre fader input peak level in dB * 100
+    int16_t outputLeveldB100[64];     // bus output peak level in dB * 100
+    uint32_t TransportBit;            // Transport Status
+    uint32_t stripState[8];           // Strip Buttons Status
+    uint32_t busState[8];             // Bus Buttons Status
+    int16_t stripGaindB100Layer1[8];  // Strip Gain in dB * 100
+    int16_t stripGaindB100Layer2[8];
+    int16_t stripGaindB100Layer3[8];
+    int16_t stripGaindB100Layer4[8];
+    int16_t stripGaindB100Layer5[8];
+    int16_t stripGaindB100Layer6[8];
+    int16_t stripGaindB100Layer7[8];
+    int16_t stripGaindB100Layer8[8];
+    int16_t busGaindB100[8];       // Bus Gain in dB * 100
     char stripLabelUTF8c60[8][60]; // Strip Label
     char busLabelUTF8c60[8][60];   // Bus Label
 };
 
 struct tagVBAN_HEADER
 {
-    unsigned long vban;       // contains 'V' 'B', 'A', 'N'
-    unsigned char format_SR;  // SR index
-    unsigned char format_nbs; // nb sample per frame (1 to 256)
-    unsigned char format_nbc; // nb channel (1 to 256)
-    unsigned char format_bit; // mask = 0x07
-    char streamname[16];      // stream name
-    unsigned long nuFrame;    // growing frame number
+    uint32_t vban;       // contains 'V' 'B', 'A', 'N'
+    uint8_t format_SR;   // SR index
+    uint8_t format_nbs;  // nb sample per frame (1 to 256)
+    uint8_t format_nbc;  // nb channel (1 to 256)
+    uint8_t format_bit;  // mask = 0x07
+    char streamname[16]; // stream name
+    uint32_t nuFrame;    // growing frame number
 };
 
+// Documented Voicemeeter RT packet layout (VBAN header is the first 28 bytes)
+static_assert(sizeof(tagVBAN_HEADER) == 28, "VBAN header must be 28 bytes");
+static_assert(offsetof(tagVBAN_HEADER, nuFrame) == 24, "VBAN header layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, frameCounter) == 24, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, voicemeeterType) == 28, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, buffersize) == 30, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, voicemeeterVersion) == 32, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, samplerate) == 40, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, inputLeveldB100) == 44, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, outputLeveldB100) == 112, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, TransportBit) == 240, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, stripState) == 244, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, busState) == 276, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, stripGaindB100Layer1) == 308, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, busGaindB100) == 436, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, stripLabelUTF8c60) == 452, "RT packet layout mismatch");
+static_assert(offsetof(tagVBAN_VMRT_PACKET, busLabelUTF8c60) == 932, "RT packet layout mismatch");
+static_assert(sizeof(tagVBAN_VMRT_PACKET) == 1412, "RT packet must be 1412 bytes");
+
+// The display has always read strip n's main gain from flat index n + 8 of the stripGaindB100 layers
+// (i.e. stripGaindB100Layer2[n]); keep every reader on the same slot.
+#define VMRT_STRIP_GAIN_INDEX(strip) ((strip) + 8)
+
+inline int16_t vmrtStripGain(const tagVBAN_VMRT_PACKET &packet, uint8_t strip)
+{
+    int16_t gain;
+    const uint8_t *layers = reinterpret_cast<const uint8_t *>(&packet) + offsetof(tagVBAN_VMRT_PACKET, stripGaindB100Layer1);
+    memcpy(&gain, layers + VMRT_STRIP_GAIN_INDEX(strip) * sizeof(int16_t), sizeof(gain));
+    return gain;
+}
+
 #define VBAN_PROTOCOL_MASK 0xE0
+#define VBAN_PROTOCOL_TXT 0x40
 #define VBAN_PROTOCOL_SERVICE 0x60
 #define VBAN_SERVICE_RTPACKETREGISTER 32
 #define VBAN_SERVICE_RTPACKET 33
 
+#define VMRTSTATE_MODE_MUTE 0x00000001
 #define VMRTSTATE_MODE_BUSA1 0x00001000
 #define VMRTSTATE_MODE_BUSA2 0x00002000
 #define VMRTSTATE_MODE_BUSA3 0x00004000
 #define VMRTSTATE_MODE_BUSA4 0x00008000
+#define VMRTSTATE_MODE_BUSB1 0x00010000
+#define VMRTSTATE_MODE_BUSB2 0x00020000
+#define VMRTSTATE_MODE_BUSB3 0x00040000
 #define VMRTSTATE_MODE_BUSA5 0x00080000
@@ -0,0 +1,19 @@
+#pragma once
+// Native stand-in for the MAX17048 fuel gauge; readings come from NativeHal::setBattery().
+#include <Arduino.h>
+#include <Wire.h>
+
+class Adafruit_MAX17048
+{
+public:
+    bool begin(TwoWire *wire = &Wire)
+    {
+        (void)wire;
+        return true;
+    }
+    void wake() {}
+    void hibernate() {}
+    float cellVoltage();
+    float cellPercent();
+    float chargeRate();
+};
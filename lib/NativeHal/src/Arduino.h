@@ -0,0 +1,195 @@
+#pragma once
+// Native stand-in for the ESP32 Arduino core: just the surface the firmware uses.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "NativeHal.h"
+
+#define IRAM_ATTR
+#define PI 3.1415926535897932384626433832795
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+class String
+{
+public:
+    String(const char *cstr = "") : buffer(cstr ? cstr : "") {}
+    String(const std::string &str) : buffer(str) {}
+    explicit String(char c) : buffer(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10) : String((unsigned long)value, base) {}
+    explicit String(int value, unsigned char base = 10) : String((long)value, base) {}
+    explicit String(unsigned int value, unsigned char base = 10) : String((unsigned long)value, base) {}
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2) : String((double)value, decimalPlaces) {}
+    explicit String(double value, unsigned int decimalPlaces = 2);
+
+    const char *c_str() const { return buffer.c_str(); }
+    unsigned int length() const { return buffer.length(); }
+    char *begin() { return &buffer[0]; }
+    char *end() { return &buffer[0] + buffer.length(); }
+    const char *begin() const { return buffer.data(); }
+    const char *end() const { return buffer.data() + buffer.length(); }
+    char operator[](unsigned int index) const { return index < buffer.length() ? buffer[index] : 0; }
+    long toInt() const { return atol(buffer.c_str()); }
+    float toFloat() const { return atof(buffer.c_str()); }
+    bool equals(const String &other) const { return buffer == other.buffer; }
+    bool operator==(const String &other) const { return buffer == other.buffer; }
+    bool operator!=(const String &other) const { return buffer != other.buffer; }
+
+    String &operator+=(const String &other)
+    {
+        buffer += other.buffer;
+        return *this;
+    }
+    String &operator+=(const char *other)
+    {
+        buffer += other;
+        return *this;
+    }
+    String &operator+=(char c)
+    {
+        buffer += c;
+        return *this;
+    }
+    friend String operator+(const String &lhs, const String &rhs) { return String(lhs.buffer + rhs.buffer); }
+    friend String operator+(const String &lhs, const char *rhs) { return String(lhs.buffer + rhs); }
+    friend String operator+(const char *lhs, const String &rhs) { return String(lhs + rhs.buffer); }
+
+private:
+    std::string buffer;
+};
+
+class IPAddress
+{
+public:
+    IPAddress() : bytes{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+    IPAddress(uint32_t address) { memcpy(bytes, &address, 4); }
+    operator uint32_t() const
+    {
+        uint32_t address;
+        memcpy(&address, bytes, 4);
+        return address;
+    }
+    uint8_t operator[](int index) const { return bytes[index]; }
+    uint8_t &operator[](int index) { return bytes[index]; }
+    bool operator==(const IPAddress &other) const { return memcmp(bytes, other.bytes, 4) == 0; }
+    bool fromString(const char *address);
+    bool fromString(const String &address) { return fromString(address.c_str()); }
+    String toString() const;
+
+private:
+    uint8_t bytes[4];
+};
+
+class HardwareSerial
+{
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    operator bool() const { return true; }
+    int available();
+    int read();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *data, size_t size);
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const char *str);
+    size_t print(const String &str) { return print(str.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(double value, int digits = 2) { return print(String(value, digits)); }
+    size_t print(const IPAddress &address) { return print(address.toString()); }
+
+    size_t println() { return print("\r\n"); }
+    template <typename T>
+    size_t println(const T &value)
+    {
+        size_t n = print(value);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T &value, int format)
+    {
+        size_t n = print(value, format);
+        return n + println();
+    }
+};
+extern HardwareSerial Serial;
+
+class EspClass
+{
+public:
+    void restart();
+    uint32_t getFreeHeap();    // NATIVE_HEAP_SIZE (default 320 KB) minus what malloc has handed out
+    uint32_t getMinFreeHeap(); // lowest getFreeHeap() seen so far
+};
+extern EspClass ESP;
+
+typedef enum
+{
+    GPIO_NUM_0 = 0,
+    GPIO_NUM_MAX = 49
+} gpio_num_t;
+
+typedef enum
+{
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER
+} esp_sleep_wakeup_cause_t;
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+int esp_sleep_enable_ext0_wakeup(gpio_num_t pin, int level);
+int esp_sleep_enable_timer_wakeup(uint64_t timeUs);
+void esp_deep_sleep_start();
+
+// Provided by the sketch
+void setup();
+void loop();
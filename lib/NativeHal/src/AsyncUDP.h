@@ -0,0 +1,53 @@
+#pragma once
+// Native stand-in for the ESP32 AsyncUDP library, backed by a real UDP socket and a receive thread
+// (the equivalent of the async_udp task on the device).
+#include <Arduino.h>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+class AsyncUDPPacket
+{
+public:
+    AsyncUDPPacket(uint8_t *data, size_t length, IPAddress remoteIP, uint16_t remotePort)
+        : payload(data), payloadLength(length), remoteAddress(remoteIP), remotePortNumber(remotePort) {}
+    uint8_t *data() { return payload; }
+    size_t length() const { return payloadLength; }
+    IPAddress remoteIP() const { return remoteAddress; }
+    uint16_t remotePort() const { return remotePortNumber; }
+
+private:
+    uint8_t *payload;
+    size_t payloadLength;
+    IPAddress remoteAddress;
+    uint16_t remotePortNumber;
+};
+
+typedef std::function<void(AsyncUDPPacket &packet)> AuPacketHandlerFunction;
+
+class AsyncUDP
+{
+public:
+    AsyncUDP() = default;
+    ~AsyncUDP();
+    // Binds WiFi.localIP():port so a stand-in Voicemeeter can own another loopback address on the same port
+    bool listen(uint16_t port);
+    void onPacket(AuPacketHandlerFunction callback)
+    {
+        std::lock_guard<std::mutex> lock(handlerMutex);
+        handler = callback;
+    }
+    size_t writeTo(const uint8_t *data, size_t length, const IPAddress &address, uint16_t port);
+    void close();
+    bool connected() const { return socketFd >= 0; }
+
+private:
+    void receiveLoop();
+
+    int socketFd = -1;
+    std::atomic<bool> running{false};
+    std::thread receiver;
+    std::mutex handlerMutex; // the receive thread may already be running when onPacket() is called
+    AuPacketHandlerFunction handler;
+};
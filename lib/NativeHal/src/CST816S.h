@@ -0,0 +1,30 @@
+#pragma once
+// Native stand-in for the CST816S touch controller; touches come from NativeHal::setTouch().
+#include <Arduino.h>
+
+struct data_struct
+{
+    byte gestureID;
+    byte points;
+    byte event;
+    int x;
+    int y;
+    uint8_t version;
+    uint8_t versionInfo[3];
+};
+
+class CST816S
+{
+public:
+    CST816S(int sda, int scl, int rst, int irq)
+    {
+        (void)sda;
+        (void)scl;
+        (void)rst;
+        (void)irq;
+    }
+    void begin(int interrupt = RISING) { (void)interrupt; }
+    bool available();
+    String gesture() { return String("NONE"); }
+    data_struct data = {};
+};
@@ -0,0 +1,184 @@
+// Native FreeRTOS tasks, queues and mutexes on top of std::thread and condition variables.
+#include <Arduino.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <chrono>
+
+struct NativeTask
+{
+    const char *name;
+    std::mutex mutex;
+    std::condition_variable notified;
+    uint32_t notifyCount = 0;
+};
+
+static thread_local NativeTask *s_currentTask = nullptr;
+
+struct NativeQueue
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+};
+
+struct NativeSemaphore
+{
+    std::mutex mutex;
+    std::condition_variable released;
+    bool taken = false;
+};
+
+// Blocks on cv until ready() or ticksToWait (simulated ms) elapse
+template <typename Predicate>
+static bool waitFor(std::condition_variable &cv, std::unique_lock<std::mutex> &lock, TickType_t ticksToWait, Predicate ready)
+{
+    if (ticksToWait == portMAX_DELAY)
+    {
+        cv.wait(lock, ready);
+        return true;
+    }
+    auto realTimeout = std::chrono::duration<double, std::milli>(ticksToWait / NativeHal::getTimeScale());
+    return cv.wait_for(lock, realTimeout, ready);
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return (TickType_t)millis();
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    delay(ticks);
+}
+
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t period)
+{
+    TickType_t wakeTime = *previousWakeTime + period;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(wakeTime - now) > 0)
+        delay(wakeTime - now);
+    *previousWakeTime = wakeTime;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stackDepth, void *parameters,
+                                   UBaseType_t priority, TaskHandle_t *createdTask, BaseType_t coreId)
+{
+    (void)stackDepth;
+    (void)priority;
+    (void)coreId;
+    NativeTask *handle = new NativeTask();
+    handle->name = name;
+    if (createdTask)
+        *createdTask = handle;
+    std::thread([task, parameters, handle]
+                {
+                    s_currentTask = handle;
+                    task(parameters); })
+        .detach();
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    if (!s_currentTask)
+    {
+        s_currentTask = new NativeTask(); // the main (loopTask) thread
+        s_currentTask->name = "loopTask";
+    }
+    return s_currentTask;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    std::lock_guard<std::mutex> lock(task->mutex);
+    task->notifyCount++;
+    task->notified.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken)
+{
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken)
+        *higherPriorityTaskWoken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+    NativeTask *task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> lock(task->mutex);
+    waitFor(task->notified, lock, ticksToWait, [task]
+            { return task->notifyCount > 0; });
+    uint32_t count = task->notifyCount;
+    if (count)
+        task->notifyCount = clearCountOnExit ? 0 : count - 1;
+    return count;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    NativeQueue *queue = new NativeQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitFor(queue->changed, lock, ticksToWait, [queue]
+                 { return queue->items.size() < queue->length; }))
+        return pdFALSE;
+    const uint8_t *bytes = static_cast<const uint8_t *>(item);
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitFor(queue->changed, lock, ticksToWait, [queue]
+                 { return !queue->items.empty(); }))
+        return pdFALSE;
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->items.size();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new NativeSemaphore();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait)
+{
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    if (!waitFor(semaphore->released, lock, ticksToWait, [semaphore]
+                 { return !semaphore->taken; }))
+        return pdFALSE;
+    semaphore->taken = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    std::lock_guard<std::mutex> lock(semaphore->mutex);
+    if (!semaphore->taken)
+        return pdFALSE;
+    semaphore->taken = false;
+    semaphore->released.notify_one();
+    return pdTRUE;
+}
@@ -0,0 +1,74 @@
+#pragma once
+// Native stand-in for functionpointer/arduino-MLX90393. The sensor sees a magnet at
+// NativeHal::setKnobAngle() and raises its INT pin at the configured burst rate.
+#include <Arduino.h>
+#include <Wire.h>
+
+class MLX90393Hal
+{
+public:
+    virtual ~MLX90393Hal() = default;
+    void set_address(uint8_t address) { i2cAddress = address; }
+
+protected:
+    uint8_t i2cAddress = 0x0C;
+};
+
+class MLX90393ArduinoHal : public MLX90393Hal
+{
+public:
+    void set_twoWire(TwoWire *wire) { twoWire = wire; }
+
+private:
+    TwoWire *twoWire = nullptr;
+};
+
+class MLX90393
+{
+public:
+    enum
+    {
+        X_FLAG = 0x2,
+        Y_FLAG = 0x4,
+        Z_FLAG = 0x8,
+        T_FLAG = 0x1
+    };
+    enum
+    {
+        STATUS_OK = 0x00,
+        STATUS_ERROR = 0xff
+    };
+    struct txyzRaw
+    {
+        uint16_t t;
+        uint16_t x;
+        uint16_t y;
+        uint16_t z;
+    };
+
+    // Simulated INT pin, matching RotationManager::INT_PIN on the board
+    static const uint8_t SIMULATED_INT_PIN = 10;
+
+    uint8_t begin_with_hal(MLX90393Hal *hal, int A1 = 0, int A0 = 0);
+    uint8_t exit();
+    uint8_t reset();
+    uint8_t checkStatus(uint8_t status) { return (status & 0x10) ? STATUS_ERROR : STATUS_OK; }
+    uint8_t setGainSel(uint8_t gain) { return setField(0, 0x0070, 4, gain); }
+    uint8_t setResolution(uint8_t x, uint8_t y, uint8_t z);
+    uint8_t setOverSampling(uint8_t oversampling) { return setField(2, 0x0003, 0, oversampling); }
+    uint8_t setDigitalFiltering(uint8_t filter) { return setField(2, 0x001c, 2, filter); }
+    uint8_t setTemperatureCompensation(uint8_t enabled) { return setField(1, 0x0400, 10, enabled); }
+    uint8_t setWOXYThreshold(uint16_t threshold) { return writeRegister(7, threshold); }
+    uint8_t readRegister(uint8_t address, uint16_t &data);
+    uint8_t writeRegister(uint8_t address, uint16_t data);
+    uint8_t startBurst(uint8_t zyxtFlags);
+    uint8_t startWakeOnChange(uint8_t zyxtFlags);
+    // Returns the status byte of the read; non-zero when a sample was delivered
+    uint8_t readMeasurement(uint8_t zyxtFlags, txyzRaw &result);
+
+private:
+    uint8_t setField(uint8_t address, uint16_t mask, uint8_t shift, uint16_t value);
+
+    MLX90393Hal *hal = nullptr;
+    uint16_t registers[64] = {0};
+};
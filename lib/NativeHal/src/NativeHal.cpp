@@ -0,0 +1,369 @@
+// Native Arduino core: time, GPIO, interrupts, Serial, String, IPAddress and the sketch entry point.
+#include <Arduino.h>
+#include <malloc.h>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <map>
+#include <poll.h>
+#include <unistd.h>
+#include <stdio.h>
+
+using Clock = std::chrono::steady_clock;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static std::mutex s_timeMutex;
+static Clock::time_point s_anchorReal = Clock::now();
+static double s_anchorSimMs = 0;
+static double s_timeScale = getenv("NATIVE_TIME_SCALE") ? atof(getenv("NATIVE_TIME_SCALE")) : 1.0;
+static unsigned long s_runLimitMs = getenv("NATIVE_RUN_MS") ? strtoul(getenv("NATIVE_RUN_MS"), nullptr, 10) : 0;
+
+static double simulatedMs()
+{
+    std::lock_guard<std::mutex> lock(s_timeMutex);
+    double realMs = std::chrono::duration<double, std::milli>(Clock::now() - s_anchorReal).count();
+    return s_anchorSimMs + realMs * s_timeScale;
+}
+
+static void sleepSimulatedMs(double ms)
+{
+    if (ms <= 0)
+    {
+        std::this_thread::yield();
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms / NativeHal::getTimeScale()));
+}
+
+void NativeHal::setTimeScale(double scale)
+{
+    if (scale <= 0)
+        return;
+    double now = simulatedMs();
+    std::lock_guard<std::mutex> lock(s_timeMutex);
+    s_anchorReal = Clock::now();
+    s_anchorSimMs = now;
+    s_timeScale = scale;
+}
+
+double NativeHal::getTimeScale()
+{
+    std::lock_guard<std::mutex> lock(s_timeMutex);
+    return s_timeScale > 0 ? s_timeScale : 1.0;
+}
+
+void NativeHal::setRunLimit(unsigned long simulatedMs)
+{
+    s_runLimitMs = simulatedMs;
+}
+
+unsigned long millis()
+{
+    return (unsigned long)simulatedMs();
+}
+
+unsigned long micros()
+{
+    return (unsigned long)(simulatedMs() * 1000.0);
+}
+
+void delay(uint32_t ms)
+{
+    sleepSimulatedMs(ms);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    sleepSimulatedMs(us / 1000.0);
+}
+
+// GPIO ---------------------------------------------------------------------
+
+static uint8_t s_pinLevels[GPIO_NUM_MAX] = {0};
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin < GPIO_NUM_MAX)
+        s_pinLevels[pin] = value;
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < GPIO_NUM_MAX ? s_pinLevels[pin] : LOW;
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+    if (pin < GPIO_NUM_MAX)
+        s_pinLevels[pin] = value > 0 ? HIGH : LOW;
+}
+
+// Interrupts ---------------------------------------------------------------
+
+struct PeriodicInterrupt
+{
+    uint32_t periodMs;
+    double nextDueMs;
+};
+
+// Deliberately leaked: the interrupt thread outlives static destruction when the sketch calls exit()
+static std::mutex &s_isrMutex = *new std::mutex();
+static std::map<uint8_t, void (*)(void)> &s_isrs = *new std::map<uint8_t, void (*)(void)>();
+static std::map<uint8_t, PeriodicInterrupt> &s_periodicInterrupts = *new std::map<uint8_t, PeriodicInterrupt>();
+static bool s_interruptThreadStarted = false;
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode)
+{
+    (void)mode;
+    std::lock_guard<std::mutex> lock(s_isrMutex);
+    s_isrs[pin] = isr;
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    std::lock_guard<std::mutex> lock(s_isrMutex);
+    s_isrs.erase(pin);
+}
+
+void NativeHal::raiseInterrupt(uint8_t pin)
+{
+    void (*isr)(void) = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(s_isrMutex);
+        auto it = s_isrs.find(pin);
+        if (it != s_isrs.end())
+            isr = it->second;
+    }
+    if (isr)
+        isr();
+}
+
+static void interruptThread()
+{
+    for (;;)
+    {
+        double now = simulatedMs();
+        double nextDue = now + 50;
+        uint8_t duePins[8];
+        size_t dueCount = 0;
+        {
+            std::lock_guard<std::mutex> lock(s_isrMutex);
+            for (auto &entry : s_periodicInterrupts)
+            {
+                if (entry.second.nextDueMs <= now && dueCount < sizeof(duePins))
+                {
+                    duePins[dueCount++] = entry.first;
+                    entry.second.nextDueMs += entry.second.periodMs;
+                    if (entry.second.nextDueMs < now)
+                        entry.second.nextDueMs = now + entry.second.periodMs; // don't replay a backlog
+                }
+                nextDue = std::min(nextDue, entry.second.nextDueMs);
+            }
+        }
+        for (size_t i = 0; i < dueCount; i++)
+            NativeHal::raiseInterrupt(duePins[i]);
+        sleepSimulatedMs(nextDue - simulatedMs());
+    }
+}
+
+void NativeHal::schedulePeriodicInterrupt(uint8_t pin, uint32_t periodMs)
+{
+    std::lock_guard<std::mutex> lock(s_isrMutex);
+    s_periodicInterrupts[pin] = {periodMs ? periodMs : 1, simulatedMs() + periodMs};
+    if (!s_interruptThreadStarted)
+    {
+        std::thread(interruptThread).detach();
+        s_interruptThreadStarted = true;
+    }
+}
+
+void NativeHal::cancelPeriodicInterrupt(uint8_t pin)
+{
+    std::lock_guard<std::mutex> lock(s_isrMutex);
+    s_periodicInterrupts.erase(pin);
+}
+
+// String / IPAddress -------------------------------------------------------
+
+String::String(long value, unsigned char base)
+{
+    if (base == 10)
+        buffer = std::to_string(value);
+    else
+        *this = String((unsigned long)value, base);
+}
+
+String::String(unsigned long value, unsigned char base)
+{
+    if (base < 2 || base > 16)
+        base = 10;
+    char digits[sizeof(unsigned long) * 8 + 1];
+    char *cursor = digits + sizeof(digits) - 1;
+    *cursor = '\0';
+    do
+    {
+        *--cursor = "0123456789ABCDEF"[value % base];
+        value /= base;
+    } while (value);
+    buffer = cursor;
+}
+
+String::String(double value, unsigned int decimalPlaces)
+{
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", (int)decimalPlaces, value);
+    buffer = text;
+}
+
+bool IPAddress::fromString(const char *address)
+{
+    unsigned int parts[4];
+    if (sscanf(address, "%u.%u.%u.%u", &parts[0], &parts[1], &parts[2], &parts[3]) != 4)
+        return false;
+    for (int i = 0; i < 4; i++)
+    {
+        if (parts[i] > 255)
+            return false;
+        bytes[i] = parts[i];
+    }
+    return true;
+}
+
+String IPAddress::toString() const
+{
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return String(text);
+}
+
+// Serial -------------------------------------------------------------------
+
+int HardwareSerial::available()
+{
+    pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    return poll(&fd, 1, 0) > 0 && (fd.revents & POLLIN) ? 1 : 0;
+}
+
+int HardwareSerial::read()
+{
+    if (!available())
+        return -1;
+    uint8_t c;
+    return ::read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t *data, size_t size)
+{
+    size_t written = fwrite(data, 1, size, stdout);
+    fflush(stdout);
+    return written;
+}
+
+size_t HardwareSerial::print(const char *str)
+{
+    size_t written = fputs(str, stdout) >= 0 ? strlen(str) : 0;
+    fflush(stdout);
+    return written;
+}
+
+size_t HardwareSerial::printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int written = vprintf(format, args);
+    va_end(args);
+    fflush(stdout);
+    return written > 0 ? written : 0;
+}
+
+// ESP ----------------------------------------------------------------------
+
+void EspClass::restart()
+{
+    Serial.println("[native] ESP.restart()");
+    ::exit(0);
+}
+
+static uint32_t s_minFreeHeap = UINT32_MAX;
+
+uint32_t EspClass::getFreeHeap()
+{
+    static const size_t heapSize = getenv("NATIVE_HEAP_SIZE") ? strtoul(getenv("NATIVE_HEAP_SIZE"), nullptr, 10) : 320 * 1024;
+    size_t used = mallinfo2().uordblks;
+    uint32_t free = used < heapSize ? heapSize - used : 0;
+    if (free < s_minFreeHeap)
+        s_minFreeHeap = free;
+    return free;
+}
+
+uint32_t EspClass::getMinFreeHeap()
+{
+    getFreeHeap();
+    return s_minFreeHeap;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause()
+{
+    return ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+int esp_sleep_enable_ext0_wakeup(gpio_num_t pin, int level)
+{
+    (void)pin;
+    (void)level;
+    return 0;
+}
+
+int esp_sleep_enable_timer_wakeup(uint64_t timeUs)
+{
+    (void)timeUs;
+    return 0;
+}
+
+void esp_deep_sleep_start()
+{
+    Serial.printf("[native] deep sleep at %lu ms\n", millis());
+    ::exit(0);
+}
+
+// Sketch entry point -------------------------------------------------------
+
+static int s_argc = 0;
+static char **s_argv = nullptr;
+
+int NativeHal::getArgc()
+{
+    return s_argc;
+}
+
+char **NativeHal::getArgv()
+{
+    return s_argv;
+}
+
+int main(int argc, char **argv)
+{
+    s_argc = argc;
+    s_argv = argv;
+    setup();
+    for (;;)
+    {
+        loop();
+        if (s_runLimitMs && millis() >= s_runLimitMs)
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+    Simulation controls for the native (host) build.
+
+    The shims in this library stand in for the ESP32 Arduino core and the board's
+    peripherals. Anything a real device would get from the outside world (knob
+    position, battery gauge, Wi-Fi link, touch) is injected through here.
+*/
+namespace NativeHal
+{
+    // Time: millis() runs timeScale times faster than the wall clock and delays shrink to match.
+    // Defaults to the NATIVE_TIME_SCALE environment variable, or 1.
+    void setTimeScale(double scale);
+    double getTimeScale();
+
+    // Magnetometer: absolute knob angle in degrees, reported on the next burst sample
+    void setKnobAngle(float degrees);
+    float getKnobAngle();
+
+    // Battery gauge (MAX17048)
+    void setBattery(float voltage, float percent, float chargeRatePercentPerHour);
+
+    // Wi-Fi link state reported by WiFi.status()
+    void setWiFiConnected(bool connected);
+
+    // Touch controller (CST816S): a single press/release at x, y
+    void setTouch(bool pressed, uint16_t x, uint16_t y);
+
+    // Display (TFT_eSPI): in-memory RGB565 framebuffer and flush accounting
+    const uint16_t *getFramebuffer();
+    uint16_t getFramebufferWidth();
+    uint16_t getFramebufferHeight();
+    uint64_t getPixelsPushed();
+    bool writeFramebufferPPM(const char *path);
+
+    // GPIO interrupts: raise a pin once, or periodically from the simulated interrupt thread
+    // (the magnetometer shim uses this for its INT pin in burst mode)
+    void raiseInterrupt(uint8_t pin);
+    void schedulePeriodicInterrupt(uint8_t pin, uint32_t periodMs);
+    void cancelPeriodicInterrupt(uint8_t pin);
+
+    // Optional run limit in simulated milliseconds (NATIVE_RUN_MS); 0 runs forever
+    void setRunLimit(unsigned long simulatedMs);
+
+    // Command line of the host process, for sketches that take options
+    int getArgc();
+    char **getArgv();
+}
@@ -0,0 +1,283 @@
+// Native WiFi and AsyncUDP over real (loopback) UDP sockets.
+#include <AsyncUDP.h>
+#include <WiFi.h>
+#include <esp_wifi.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClass WiFi;
+
+static std::atomic<bool> s_wifiConnected{true};
+
+void NativeHal::setWiFiConnected(bool connected)
+{
+    s_wifiConnected = connected;
+}
+
+wl_status_t WiFiClass::status()
+{
+    return s_wifiConnected ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+// NATIVE_LOCAL_IP overrides the device address; the default pairs with a stand-in Voicemeeter on 127.0.0.2
+IPAddress WiFiClass::localIP()
+{
+    IPAddress address(127, 0, 0, 1);
+    if (getenv("NATIVE_LOCAL_IP"))
+        address.fromString(getenv("NATIVE_LOCAL_IP"));
+    return address;
+}
+
+esp_err_t esp_wifi_stop()
+{
+    s_wifiConnected = false;
+    return 0;
+}
+
+static sockaddr_in toSockaddr(const IPAddress &address, uint16_t port)
+{
+    sockaddr_in socketAddress = {};
+    socketAddress.sin_family = AF_INET;
+    socketAddress.sin_port = htons(port);
+    socketAddress.sin_addr.s_addr = (uint32_t)address; // IPAddress already holds network byte order
+    return socketAddress;
+}
+
+AsyncUDP::~AsyncUDP()
+{
+    close();
+}
+
+bool AsyncUDP::listen(uint16_t port)
+{
+    close();
+    socketFd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socketFd < 0)
+        return false;
+    int reuse = 1;
+    setsockopt(socketFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    timeval timeout = {0, 100000}; // lets the receive thread notice close()
+    setsockopt(socketFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in local = toSockaddr(WiFi.localIP(), port);
+    if (bind(socketFd, (sockaddr *)&local, sizeof(local)) != 0)
+    {
+        ::close(socketFd);
+        socketFd = -1;
+        return false;
+    }
+    running = true;
+    receiver = std::thread(&AsyncUDP::receiveLoop, this);
+    return true;
+}
+
+void AsyncUDP::receiveLoop()
+{
+    uint8_t buffer[2048];
+    while (running)
+    {
+        sockaddr_in remote = {};
+        socklen_t remoteLength = sizeof(remote);
+        ssize_t received = recvfrom(socketFd, buffer, sizeof(buffer), 0, (sockaddr *)&remote, &remoteLength);
+        if (received <= 0)
+            continue;
+        std::lock_guard<std::mutex> lock(handlerMutex);
+        if (!handler)
+            continue;
+        AsyncUDPPacket packet(buffer, received, IPAddress((uint32_t)remote.sin_addr.s_addr), ntohs(remote.sin_port));
+        handler(packet);
+    }
+}
+
+size_t AsyncUDP::writeTo(const uint8_t *data, size_t length, const IPAddress &address, uint16_t port)
+{
+    if (socketFd < 0)
+    {
+        socketFd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (socketFd < 0)
+            return 0;
+    }
+    if (WiFi.status() != WL_CONNECTED)
+        return 0;
+    sockaddr_in remote = toSockaddr(address, port);
+    ssize_t sent = sendto(socketFd, data, length, 0, (sockaddr *)&remote, sizeof(remote));
+    return sent > 0 ? sent : 0;
+}
+
+void AsyncUDP::close()
+{
+    running = false;
+    if (receiver.joinable())
+        receiver.join();
+    if (socketFd >= 0)
+        ::close(socketFd);
+    socketFd = -1;
+}
+
+// lwIP raw UDP ---------------------------------------------------------------
+
+#include <lwip/udp.h>
+#include <lwip/priv/tcpip_priv.h>
+
+const ip_addr_t ip_addr_any_type = {0};
+
+// Everything that would run on the tcpip thread takes this, like the core lock on the device
+static std::recursive_mutex s_tcpipMutex;
+
+struct udp_pcb
+{
+    int fd = -1;
+    udp_recv_fn recv = nullptr;
+    void *recvArg = nullptr;
+    std::atomic<bool> running{false};
+    std::thread receiver;
+};
+
+// NATIVE_PBUF_CHUNK splits received datagrams into a pbuf chain of that many bytes per link,
+// so the chained path can be exercised on the host
+static u16_t pbufChunk()
+{
+    static u16_t chunk = getenv("NATIVE_PBUF_CHUNK") ? (u16_t)atoi(getenv("NATIVE_PBUF_CHUNK")) : 0;
+    return chunk;
+}
+
+static void udpReceiveLoop(udp_pcb *pcb)
+{
+    static const int MAX_LINKS = 8;
+    uint8_t buffer[2048];
+    pbuf chain[MAX_LINKS];
+    while (pcb->running)
+    {
+        sockaddr_in remote = {};
+        socklen_t remoteLength = sizeof(remote);
+        ssize_t received = recvfrom(pcb->fd, buffer, sizeof(buffer), 0, (sockaddr *)&remote, &remoteLength);
+        if (received <= 0)
+            continue;
+
+        u16_t chunk = pbufChunk() ? pbufChunk() : (u16_t)received;
+        int links = 0;
+        for (ssize_t offset = 0; offset < received && links < MAX_LINKS; offset += chunk, links++)
+        {
+            bool last = offset + chunk >= received || links == MAX_LINKS - 1;
+            chain[links].payload = buffer + offset;
+            chain[links].len = last ? (u16_t)(received - offset) : chunk;
+            chain[links].tot_len = (u16_t)(received - offset);
+            chain[links].next = last ? nullptr : &chain[links + 1];
+            chain[links].pooled = 1;
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(s_tcpipMutex);
+        ip_addr_t from = {(uint32_t)remote.sin_addr.s_addr};
+        if (pcb->recv)
+            pcb->recv(pcb->recvArg, pcb, &chain[0], &from, ntohs(remote.sin_port));
+    }
+}
+
+udp_pcb *udp_new(void)
+{
+    udp_pcb *pcb = new udp_pcb();
+    pcb->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (pcb->fd < 0)
+    {
+        delete pcb;
+        return nullptr;
+    }
+    timeval timeout = {0, 100000}; // lets the receive thread notice udp_remove()
+    setsockopt(pcb->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return pcb;
+}
+
+err_t udp_bind(udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
+{
+    int reuse = 1;
+    setsockopt(pcb->fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    // Like the AsyncUDP shim: bind the device address so a stand-in Voicemeeter can own the port elsewhere
+    IPAddress address = ipaddr->addr ? IPAddress(ipaddr->addr) : WiFi.localIP();
+    sockaddr_in local = toSockaddr(address, port);
+    if (bind(pcb->fd, (sockaddr *)&local, sizeof(local)) != 0)
+        return ERR_USE;
+    pcb->running = true;
+    pcb->receiver = std::thread(udpReceiveLoop, pcb);
+    return ERR_OK;
+}
+
+void udp_recv(udp_pcb *pcb, udp_recv_fn recv, void *recv_arg)
+{
+    pcb->recv = recv;
+    pcb->recvArg = recv_arg;
+}
+
+err_t udp_sendto(udp_pcb *pcb, pbuf *p, const ip_addr_t *dst_ip, u16_t dst_port)
+{
+    if (WiFi.status() != WL_CONNECTED)
+        return ERR_CONN;
+    uint8_t buffer[2048];
+    u16_t length = pbuf_copy_partial(p, buffer, sizeof(buffer), 0);
+    sockaddr_in remote = toSockaddr(IPAddress(dst_ip->addr), dst_port);
+    return sendto(pcb->fd, buffer, length, 0, (sockaddr *)&remote, sizeof(remote)) == length ? ERR_OK : ERR_BUF;
+}
+
+void udp_remove(udp_pcb *pcb)
+{
+    pcb->running = false;
+    if (pcb->receiver.joinable() && pcb->receiver.get_id() != std::this_thread::get_id())
+        pcb->receiver.join();
+    ::close(pcb->fd);
+    delete pcb;
+}
+
+pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type)
+{
+    (void)layer;
+    (void)type;
+    pbuf *p = (pbuf *)malloc(sizeof(pbuf) + length);
+    if (!p)
+        return nullptr;
+    p->next = nullptr;
+    p->payload = p + 1;
+    p->tot_len = length;
+    p->len = length;
+    p->pooled = 0;
+    return p;
+}
+
+u8_t pbuf_free(pbuf *p)
+{
+    if (!p || p->pooled)
+        return 0;
+    free(p);
+    return 1;
+}
+
+err_t pbuf_take(pbuf *buf, const void *dataptr, u16_t len)
+{
+    if (len > buf->tot_len)
+        return ERR_MEM;
+    memcpy(buf->payload, dataptr, len);
+    return ERR_OK;
+}
+
+u16_t pbuf_copy_partial(const pbuf *p, void *dataptr, u16_t len, u16_t offset)
+{
+    u16_t copied = 0;
+    for (; p && copied < len; p = p->next)
+    {
+        if (offset >= p->len)
+        {
+            offset -= p->len;
+            continue;
+        }
+        u16_t n = p->len - offset < len - copied ? p->len - offset : len - copied;
+        memcpy((uint8_t *)dataptr + copied, (const uint8_t *)p->payload + offset, n);
+        copied += n;
+        offset = 0;
+    }
+    return copied;
+}
+
+err_t tcpip_api_call(tcpip_api_call_fn fn, tcpip_api_call_data *call)
+{
+    std::lock_guard<std::recursive_mutex> lock(s_tcpipMutex);
+    return fn(call);
+}
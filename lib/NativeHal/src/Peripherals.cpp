@@ -0,0 +1,236 @@
+// Native I2C/SPI peripherals: MLX90393 magnetometer, MAX17048 fuel gauge, CST816S touch and the GC9A01 panel.
+#include <MLX90393.h>
+#include <Adafruit_MAX1704X.h>
+#include <CST816S.h>
+#include <TFT_eSPI.h>
+#include <Wire.h>
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+
+TwoWire Wire;
+TwoWire Wire1;
+
+// MLX90393 -----------------------------------------------------------------
+
+static std::atomic<float> s_knobAngle{0.0f};
+
+void NativeHal::setKnobAngle(float degrees)
+{
+    s_knobAngle = degrees;
+}
+
+float NativeHal::getKnobAngle()
+{
+    return s_knobAngle;
+}
+
+uint8_t MLX90393::begin_with_hal(MLX90393Hal *halInstance, int A1, int A0)
+{
+    (void)A1;
+    (void)A0;
+    hal = halInstance;
+    return STATUS_OK;
+}
+
+uint8_t MLX90393::exit()
+{
+    NativeHal::cancelPeriodicInterrupt(SIMULATED_INT_PIN);
+    return STATUS_OK;
+}
+
+uint8_t MLX90393::reset()
+{
+    NativeHal::cancelPeriodicInterrupt(SIMULATED_INT_PIN);
+    memset(registers, 0, sizeof(registers));
+    return STATUS_OK;
+}
+
+uint8_t MLX90393::setResolution(uint8_t x, uint8_t y, uint8_t z)
+{
+    return setField(2, 0x07e0, 5, (x & 0x3) | ((y & 0x3) << 2) | ((z & 0x3) << 4));
+}
+
+uint8_t MLX90393::readRegister(uint8_t address, uint16_t &data)
+{
+    data = registers[address & 0x3f];
+    return STATUS_OK;
+}
+
+uint8_t MLX90393::writeRegister(uint8_t address, uint16_t data)
+{
+    registers[address & 0x3f] = data;
+    return STATUS_OK;
+}
+
+uint8_t MLX90393::setField(uint8_t address, uint16_t mask, uint8_t shift, uint16_t value)
+{
+    registers[address] = (registers[address] & ~mask) | ((value << shift) & mask);
+    return STATUS_OK;
+}
+
+uint8_t MLX90393::startBurst(uint8_t zyxtFlags)
+{
+    (void)zyxtFlags;
+    // Burst data rate is in 20 ms units; 0 means back-to-back conversions, roughly 10 ms at these settings
+    uint16_t burstDataRate = registers[1] & 0x3f;
+    NativeHal::schedulePeriodicInterrupt(SIMULATED_INT_PIN, burstDataRate ? burstDataRate * 20 : 10);
+    return STATUS_OK;
+}
+
+uint8_t MLX90393::startWakeOnChange(uint8_t zyxtFlags)
+{
+    (void)zyxtFlags;
+    NativeHal::cancelPeriodicInterrupt(SIMULATED_INT_PIN);
+    return STATUS_OK;
+}
+
+uint8_t MLX90393::readMeasurement(uint8_t zyxtFlags, txyzRaw &result)
+{
+    (void)zyxtFlags;
+    // RotationManager computes atan2(-y, x), so place the field vector at the knob angle
+    const float fieldStrength = 3000.0f;
+    float radians = NativeHal::getKnobAngle() * (float)PI / 180.0f;
+    result.t = 0;
+    result.x = (uint16_t)(int16_t)lroundf(fieldStrength * cosf(radians));
+    result.y = (uint16_t)(int16_t)lroundf(-fieldStrength * sinf(radians));
+    result.z = 0;
+    return 1;
+}
+
+// MAX17048 -----------------------------------------------------------------
+
+static std::atomic<float> s_batteryVoltage{4.1f};
+static std::atomic<float> s_batteryPercent{90.0f};
+static std::atomic<float> s_batteryChargeRate{1.0f}; // positive = plugged in, keeps the display awake
+
+void NativeHal::setBattery(float voltage, float percent, float chargeRatePercentPerHour)
+{
+    s_batteryVoltage = voltage;
+    s_batteryPercent = percent;
+    s_batteryChargeRate = chargeRatePercentPerHour;
+}
+
+float Adafruit_MAX17048::cellVoltage()
+{
+    return s_batteryVoltage;
+}
+
+float Adafruit_MAX17048::cellPercent()
+{
+    return s_batteryPercent;
+}
+
+float Adafruit_MAX17048::chargeRate()
+{
+    return s_batteryChargeRate;
+}
+
+// CST816S ------------------------------------------------------------------
+
+static std::mutex s_touchMutex;
+static bool s_touchPending = false;
+static data_struct s_touchData = {};
+
+void NativeHal::setTouch(bool pressed, uint16_t x, uint16_t y)
+{
+    std::lock_guard<std::mutex> lock(s_touchMutex);
+    s_touchData.points = pressed ? 1 : 0;
+    s_touchData.x = x;
+    s_touchData.y = y;
+    s_touchPending = true;
+}
+
+bool CST816S::available()
+{
+    std::lock_guard<std::mutex> lock(s_touchMutex);
+    if (!s_touchPending)
+        return false;
+    data = s_touchData;
+    s_touchPending = false;
+    return true;
+}
+
+// TFT_eSPI -----------------------------------------------------------------
+
+static uint16_t s_framebuffer[TFT_WIDTH * TFT_HEIGHT];
+static std::atomic<uint64_t> s_pixelsPushed{0};
+static int32_t s_windowX = 0, s_windowY = 0, s_windowW = TFT_WIDTH, s_windowH = TFT_HEIGHT;
+static uint32_t s_windowCursor = 0;
+
+const uint16_t *NativeHal::getFramebuffer()
+{
+    return s_framebuffer;
+}
+
+uint16_t NativeHal::getFramebufferWidth()
+{
+    return TFT_WIDTH;
+}
+
+uint16_t NativeHal::getFramebufferHeight()
+{
+    return TFT_HEIGHT;
+}
+
+uint64_t NativeHal::getPixelsPushed()
+{
+    return s_pixelsPushed;
+}
+
+bool NativeHal::writeFramebufferPPM(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return false;
+    fprintf(file, "P6\n%d %d\n255\n", TFT_WIDTH, TFT_HEIGHT);
+    for (uint32_t i = 0; i < TFT_WIDTH * TFT_HEIGHT; i++)
+    {
+        uint16_t pixel = s_framebuffer[i];
+        uint8_t rgb[3] = {(uint8_t)((pixel >> 8) & 0xf8), (uint8_t)((pixel >> 3) & 0xfc), (uint8_t)((pixel << 3) & 0xf8)};
+        fwrite(rgb, 1, 3, file);
+    }
+    fclose(file);
+    return true;
+}
+
+TFT_eSPI::TFT_eSPI(int16_t width, int16_t height)
+{
+    (void)width;
+    (void)height;
+}
+
+void TFT_eSPI::writecommand(uint8_t command)
+{
+    (void)command;
+}
+
+void TFT_eSPI::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+    s_windowX = x;
+    s_windowY = y;
+    s_windowW = w;
+    s_windowH = h;
+    s_windowCursor = 0;
+}
+
+void TFT_eSPI::pushColors(uint16_t *data, uint32_t length, bool swap)
+{
+    for (uint32_t i = 0; i < length; i++, s_windowCursor++)
+    {
+        int32_t x = s_windowX + s_windowCursor % s_windowW;
+        int32_t y = s_windowY + s_windowCursor / s_windowW;
+        if (x < 0 || y < 0 || x >= TFT_WIDTH || y >= TFT_HEIGHT)
+            continue;
+        uint16_t pixel = data[i];
+        // swap=true means the source is in CPU byte order and would be swapped on the wire
+        s_framebuffer[y * TFT_WIDTH + x] = swap ? pixel : (uint16_t)((pixel >> 8) | (pixel << 8));
+    }
+    s_pixelsPushed += length;
+}
+
+void TFT_eSPI::fillScreen(uint32_t color)
+{
+    for (uint32_t i = 0; i < TFT_WIDTH * TFT_HEIGHT; i++)
+        s_framebuffer[i] = color;
+}
@@ -0,0 +1,84 @@
+// Native Preferences: one process-wide key/value map, namespaced like NVS.
+#include <Preferences.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Deliberately leaked: the UDP receive thread may still save preferences while the process exits
+static std::mutex &s_storeMutex = *new std::mutex();
+static std::map<std::string, std::vector<uint8_t>> &s_store = *new std::map<std::string, std::vector<uint8_t>>();
+
+static std::string storeKey(const String &storeNamespace, const char *key)
+{
+    return std::string(storeNamespace.c_str()) + "/" + key;
+}
+
+bool Preferences::begin(const char *name, bool readOnlyMode)
+{
+    storeNamespace = String(name);
+    readOnly = readOnlyMode;
+    return true;
+}
+
+void Preferences::end()
+{
+    storeNamespace = String("");
+}
+
+bool Preferences::clear()
+{
+    if (readOnly)
+        return false;
+    std::lock_guard<std::mutex> lock(s_storeMutex);
+    std::string prefix = storeKey(storeNamespace, "");
+    for (auto it = s_store.begin(); it != s_store.end();)
+    {
+        if (it->first.compare(0, prefix.size(), prefix) == 0)
+            it = s_store.erase(it);
+        else
+            ++it;
+    }
+    return true;
+}
+
+bool Preferences::remove(const char *key)
+{
+    if (readOnly)
+        return false;
+    std::lock_guard<std::mutex> lock(s_storeMutex);
+    return s_store.erase(storeKey(storeNamespace, key)) > 0;
+}
+
+bool Preferences::isKey(const char *key)
+{
+    std::lock_guard<std::mutex> lock(s_storeMutex);
+    return s_store.count(storeKey(storeNamespace, key)) > 0;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t length)
+{
+    if (readOnly)
+        return 0;
+    std::lock_guard<std::mutex> lock(s_storeMutex);
+    const uint8_t *bytes = static_cast<const uint8_t *>(value);
+    s_store[storeKey(storeNamespace, key)] = std::vector<uint8_t>(bytes, bytes + length);
+    return length;
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+    std::lock_guard<std::mutex> lock(s_storeMutex);
+    auto it = s_store.find(storeKey(storeNamespace, key));
+    return it == s_store.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char *key, void *buffer, size_t maxLength)
+{
+    std::lock_guard<std::mutex> lock(s_storeMutex);
+    auto it = s_store.find(storeKey(storeNamespace, key));
+    if (it == s_store.end() || it->second.size() > maxLength)
+        return 0;
+    memcpy(buffer, it->second.data(), it->second.size());
+    return it->second.size();
+}
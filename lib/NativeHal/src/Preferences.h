@@ -0,0 +1,44 @@
+#pragma once
+// Native stand-in for the ESP32 NVS Preferences store, kept in memory for the life of the process.
+#include <Arduino.h>
+
+class Preferences
+{
+public:
+    bool begin(const char *name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char *key);
+    bool isKey(const char *key);
+
+    size_t putChar(const char *key, int8_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putUChar(const char *key, uint8_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putBool(const char *key, bool value) { return putUChar(key, value ? 1 : 0); }
+    size_t putInt(const char *key, int32_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putUInt(const char *key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putFloat(const char *key, float value) { return putBytes(key, &value, sizeof(value)); }
+    size_t putBytes(const char *key, const void *value, size_t length);
+
+    int8_t getChar(const char *key, int8_t defaultValue = 0) { return get(key, defaultValue); }
+    uint8_t getUChar(const char *key, uint8_t defaultValue = 0) { return get(key, defaultValue); }
+    bool getBool(const char *key, bool defaultValue = false) { return getUChar(key, defaultValue ? 1 : 0) != 0; }
+    int32_t getInt(const char *key, int32_t defaultValue = 0) { return get(key, defaultValue); }
+    uint32_t getUInt(const char *key, uint32_t defaultValue = 0) { return get(key, defaultValue); }
+    float getFloat(const char *key, float defaultValue = NAN) { return get(key, defaultValue); }
+    size_t getBytesLength(const char *key);
+    size_t getBytes(const char *key, void *buffer, size_t maxLength);
+
+private:
+    template <typename T>
+    T get(const char *key, T defaultValue)
+    {
+        T value;
+        if (getBytesLength(key) != sizeof(T))
+            return defaultValue;
+        getBytes(key, &value, sizeof(T));
+        return value;
+    }
+
+    String storeNamespace;
+    bool readOnly = false;
+};
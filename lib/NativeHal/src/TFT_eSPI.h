@@ -0,0 +1,46 @@
+#pragma once
+// Native stand-in for TFT_eSPI. Every instance draws into one shared in-memory RGB565
+// framebuffer (the GC9A01 panel), readable through NativeHal::getFramebuffer().
+#include <Arduino.h>
+
+#define TFT_WIDTH 240
+#define TFT_HEIGHT 240
+
+class TFT_eSPI
+{
+public:
+    TFT_eSPI(int16_t width = TFT_WIDTH, int16_t height = TFT_HEIGHT);
+    void init(uint8_t tc = 0) { (void)tc; }
+    void begin(uint8_t tc = 0) { init(tc); }
+    void setRotation(uint8_t rotation) { (void)rotation; }
+    void startWrite() {}
+    void endWrite() {}
+    void writecommand(uint8_t command);
+    void writedata(uint8_t data) { (void)data; }
+    void setSwapBytes(bool swap) { swapBytes = swap; }
+    bool getSwapBytes() const { return swapBytes; }
+    void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+    void pushColors(uint16_t *data, uint32_t length, bool swap = true);
+    void pushPixels(const void *data, uint32_t length) { pushColors((uint16_t *)data, length, swapBytes); }
+    void fillScreen(uint32_t color);
+    // DMA: transfers complete synchronously, so there is never anything to wait for
+    bool initDMA(bool ctrlCS = false)
+    {
+        (void)ctrlCS;
+        return true;
+    }
+    void deInitDMA() {}
+    void pushPixelsDMA(uint16_t *image, uint32_t length) { pushColors(image, length, swapBytes); }
+    void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *data)
+    {
+        setAddrWindow(x, y, w, h);
+        pushPixelsDMA(data, w * h);
+    }
+    bool dmaBusy() { return false; }
+    void dmaWait() {}
+    int16_t width() const { return TFT_WIDTH; }
+    int16_t height() const { return TFT_HEIGHT; }
+
+private:
+    bool swapBytes = false;
+};
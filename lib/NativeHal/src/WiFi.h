@@ -0,0 +1,20 @@
+#pragma once
+// Native stand-in for the ESP32 WiFi class: the host is always "connected" on loopback unless told otherwise.
+#include <Arduino.h>
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass
+{
+public:
+    wl_status_t status();
+    IPAddress localIP();
+};
+extern WiFiClass WiFi;
@@ -0,0 +1,13 @@
+#pragma once
+// Native stand-in for tzapu/WiFiManager: there is no captive portal on the host.
+#include <WiFi.h>
+
+class WiFiManager
+{
+public:
+    bool autoConnect(const char *apName)
+    {
+        (void)apName;
+        return WiFi.status() == WL_CONNECTED;
+    }
+};
@@ -0,0 +1,28 @@
+#pragma once
+// Native stand-in for the Arduino TwoWire bus; devices on it are simulated by their own shims.
+#include <Arduino.h>
+
+class TwoWire
+{
+public:
+    bool setPins(int sda, int scl)
+    {
+        (void)sda;
+        (void)scl;
+        return true;
+    }
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0)
+    {
+        (void)sda;
+        (void)scl;
+        (void)frequency;
+        return true;
+    }
+    bool setClock(uint32_t frequency)
+    {
+        (void)frequency;
+        return true;
+    }
+};
+extern TwoWire Wire;
+extern TwoWire Wire1;
@@ -0,0 +1,4 @@
+#pragma once
+// Native stand-in for esp_wifi.h
+typedef int esp_err_t;
+esp_err_t esp_wifi_stop();
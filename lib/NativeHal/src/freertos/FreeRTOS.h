@@ -0,0 +1,17 @@
+#pragma once
+// Native stand-in for the FreeRTOS types and tick helpers used by the firmware.
+// One tick is one (scaled) millisecond, like CONFIG_FREERTOS_HZ=1000 on the ESP32.
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portYIELD_FROM_ISR(x) (void)(x)
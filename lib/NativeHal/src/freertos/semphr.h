@@ -0,0 +1,9 @@
+#pragma once
+// Native stand-in for FreeRTOS mutexes (binary, non-recursive).
+#include "FreeRTOS.h"
+
+typedef struct NativeSemaphore *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
@@ -0,0 +1,40 @@
+#pragma once
+// Native stand-in for the lwIP packet buffer API, just what the raw UDP path uses
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef int8_t err_t;
+
+#define ERR_OK 0
+#define ERR_MEM -1
+#define ERR_BUF -2
+#define ERR_VAL -6
+#define ERR_USE -8
+#define ERR_CONN -11
+#define ERR_IF -12
+
+typedef enum
+{
+    PBUF_TRANSPORT
+} pbuf_layer;
+
+typedef enum
+{
+    PBUF_RAM
+} pbuf_type;
+
+struct pbuf
+{
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len; // this and all following buffers
+    u16_t len;     // this buffer
+    u8_t pooled;   // native only: owned by a receive thread, pbuf_free() leaves it alone
+};
+
+struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type);
+u8_t pbuf_free(struct pbuf *p);
+err_t pbuf_take(struct pbuf *buf, const void *dataptr, u16_t len);
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset);
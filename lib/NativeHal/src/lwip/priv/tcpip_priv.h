@@ -0,0 +1,11 @@
+#pragma once
+// Native stand-in for lwIP's tcpip_api_call: runs the function serialised with the receive threads
+#include "lwip/pbuf.h"
+
+struct tcpip_api_call_data
+{
+    err_t err;
+};
+typedef err_t (*tcpip_api_call_fn)(struct tcpip_api_call_data *call);
+
+err_t tcpip_api_call(tcpip_api_call_fn fn, struct tcpip_api_call_data *call);
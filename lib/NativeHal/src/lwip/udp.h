@@ -0,0 +1,22 @@
+#pragma once
+// Native stand-in for the lwIP raw UDP API over a real (loopback) socket. Receive callbacks run
+// on a thread of their own, the equivalent of lwIP's tcpip thread on the device.
+#include "lwip/pbuf.h"
+
+typedef struct
+{
+    uint32_t addr; // IPv4, network byte order like IPAddress
+} ip_addr_t;
+
+extern const ip_addr_t ip_addr_any_type;
+#define IP_ANY_TYPE (&ip_addr_any_type)
+#define IP_ADDR4(ipaddr, a, b, c, d) ((ipaddr)->addr = (uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+struct udp_pcb;
+typedef void (*udp_recv_fn)(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port);
+
+struct udp_pcb *udp_new(void);
+err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port); // IP_ANY_TYPE binds WiFi.localIP()
+void udp_recv(struct udp_pcb *pcb, udp_recv_fn recv, void *recv_arg);
+err_t udp_sendto(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *dst_ip, u16_t dst_port);
+void udp_remove(struct udp_pcb *pcb);
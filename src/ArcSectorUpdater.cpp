@@ -0,0 +1,129 @@
+#include "ArcSectorUpdater.h"
+
+static const int32_t ANTIALIAS_SLACK = 2; // px around each box for anti-aliased edges and chord bulge
+
+static int32_t normalizeAngle(int32_t angle)
+{
+    angle %= 360;
+    return angle < 0 ? angle + 360 : angle;
+}
+
+void ArcSectorUpdater::arcCenter(lv_obj_t *arc, lv_point_t &center, int32_t &radius)
+{
+    lv_area_t coords;
+    lv_obj_get_coords(arc, &coords);
+    int32_t left = lv_obj_get_style_pad_left(arc, LV_PART_MAIN);
+    int32_t right = lv_obj_get_style_pad_right(arc, LV_PART_MAIN);
+    int32_t top = lv_obj_get_style_pad_top(arc, LV_PART_MAIN);
+    int32_t bottom = lv_obj_get_style_pad_bottom(arc, LV_PART_MAIN);
+    radius = LV_MIN(lv_area_get_width(&coords) - left - right, lv_area_get_height(&coords) - top - bottom) / 2;
+    center.x = coords.x1 + radius + left;
+    center.y = coords.y1 + radius + top;
+}
+
+int32_t ArcSectorUpdater::indicatorInset(lv_obj_t *arc)
+{
+    return LV_MAX(LV_MAX(lv_obj_get_style_pad_left(arc, LV_PART_INDICATOR), lv_obj_get_style_pad_right(arc, LV_PART_INDICATOR)),
+                  LV_MAX(lv_obj_get_style_pad_top(arc, LV_PART_INDICATOR), lv_obj_get_style_pad_bottom(arc, LV_PART_INDICATOR)));
+}
+
+static void ringGeometry(lv_obj_t *arc, lv_point_t &center, int32_t &outer, int32_t &inner)
+{
+    int32_t r;
+    ArcSectorUpdater::arcCenter(arc, center, r);
+
+    int32_t indicPad = ArcSectorUpdater::indicatorInset(arc);
+    int32_t width = LV_MAX(lv_obj_get_style_arc_width(arc, LV_PART_MAIN), lv_obj_get_style_arc_width(arc, LV_PART_INDICATOR));
+    outer = r; // the background ring sits at the full radius, the indicator at most indicPad inside it
+    inner = r - indicPad - width;
+    if (inner < 0)
+        inner = 0;
+}
+
+static void includePoint(lv_area_t &box, lv_point_t center, int32_t radius, int32_t angle)
+{
+    int32_t x = center.x + ((radius * lv_trigo_cos(normalizeAngle(angle))) >> LV_TRIGO_SHIFT);
+    int32_t y = center.y + ((radius * lv_trigo_sin(normalizeAngle(angle))) >> LV_TRIGO_SHIFT);
+    box.x1 = LV_MIN(box.x1, x);
+    box.y1 = LV_MIN(box.y1, y);
+    box.x2 = LV_MAX(box.x2, x);
+    box.y2 = LV_MAX(box.y2, y);
+}
+
+void ArcSectorUpdater::invalidateSector(lv_obj_t *arc, int32_t startAngle, int32_t endAngle)
+{
+    int32_t rotation = lv_arc_get_rotation(arc);
+    int32_t start = normalizeAngle(startAngle + rotation);
+    int32_t span = normalizeAngle(endAngle - startAngle);
+    if (span == 0 && startAngle != endAngle)
+        span = 360;
+
+    lv_point_t center;
+    int32_t outer, inner;
+    ringGeometry(arc, center, outer, inner);
+
+    // Tile edges on multiples of TILE_DEGREES, so axis extremes (0/90/180/270) are always at a tile corner
+    int32_t a = start;
+    int32_t end = start + span;
+    do
+    {
+        int32_t next = LV_MIN(end, (a / TILE_DEGREES + 1) * TILE_DEGREES);
+        lv_area_t box;
+        box.x1 = box.x2 = center.x + ((outer * lv_trigo_cos(normalizeAngle(a))) >> LV_TRIGO_SHIFT);
+        box.y1 = box.y2 = center.y + ((outer * lv_trigo_sin(normalizeAngle(a))) >> LV_TRIGO_SHIFT);
+        includePoint(box, center, outer, next);
+        includePoint(box, center, inner, a);
+        includePoint(box, center, inner, next);
+        box.x1 -= ANTIALIAS_SLACK;
+        box.y1 -= ANTIALIAS_SLACK;
+        box.x2 += ANTIALIAS_SLACK;
+        box.y2 += ANTIALIAS_SLACK;
+        lv_obj_invalidate_area(arc, &box);
+        a = next;
+    } while (a < end);
+}
+
+int32_t ArcSectorUpdater::valueToAngle(lv_obj_t *arc, int32_t value)
+{
+    int32_t min = lv_arc_get_min_value(arc);
+    int32_t max = lv_arc_get_max_value(arc);
+    int32_t bgStart = lv_arc_get_bg_angle_start(arc);
+    int32_t bgSweep = normalizeAngle((int32_t)lv_arc_get_bg_angle_end(arc) - bgStart);
+    if (max <= min)
+        return bgStart;
+    value = LV_CLAMP(min, value, max);
+    return bgStart + bgSweep * (value - min) / (max - min);
+}
+
+void ArcSectorUpdater::setValue(lv_obj_t *arc, int32_t value)
+{
+    int32_t oldValue = lv_arc_get_value(arc);
+    if (oldValue == value)
+        return;
+    int32_t oldAngle = valueToAngle(arc, oldValue);
+    int32_t newAngle = valueToAngle(arc, value);
+
+    lv_display_t *disp = lv_obj_get_display(arc);
+    lv_display_enable_invalidation(disp, false);
+    lv_arc_set_value(arc, value);
+    lv_display_enable_invalidation(disp, true);
+
+    if (oldAngle < newAngle)
+        invalidateSector(arc, oldAngle, newAngle);
+    else
+        invalidateSector(arc, newAngle, oldAngle);
+}
+
+void ArcSectorUpdater::setAngles(lv_obj_t *arc, int32_t startAngle, int32_t endAngle)
+{
+    int32_t oldStart = lv_arc_get_angle_start(arc);
+    int32_t oldEnd = lv_arc_get_angle_end(arc);
+
+    lv_display_t *disp = lv_obj_get_display(arc);
+    lv_display_enable_invalidation(disp, false);
+    lv_arc_set_angles(arc, startAngle, endAngle);
+    lv_display_enable_invalidation(disp, true);
+
+    invalidateSector(arc, oldStart, oldEnd);
+    invalidateSector(arc, startAngle, endAngle);
+}
@@ -1,10 +1,15 @@
 #include "DisplayManager.h"
 #include "PowerManager.h"
+#include "FrameProfiler.h"
+#include "ArcSectorUpdater.h"
+#include "RingMaskCache.h"
 
 // Static member definitions for DisplayManager (must be in a single translation unit)
 TFT_eSPI DisplayManager::tft = TFT_eSPI();
 CST816S DisplayManager::touch = CST816S(37, 38, 36, 35); // sda, scl, rst, irq
-tagVBAN_VMRT_PACKET DisplayManager::latestVoicemeeterData = {0};
+static const tagVBAN_VMRT_PACKET s_emptyPacket = {0};
+const tagVBAN_VMRT_PACKET *DisplayManager::latestVoicemeeterData = &s_emptyPacket;
+PredictedState DisplayManager::predictedState;
 long DisplayManager::lastTouchTime = 0;
 short DisplayManager::selectedVolumeArc = 0;
 bool DisplayManager::connectionStatus = false;
@@ -13,10 +18,23 @@ char DisplayManager::dbLabelText[16] = "--.-- dB";
 lv_obj_t *DisplayManager::strip_arcs[numVolumeArcs] = {nullptr};
 lv_obj_t *DisplayManager::level_arcs_l[numVolumeArcs] = {nullptr};
 lv_obj_t *DisplayManager::level_arcs_r[numVolumeArcs] = {nullptr};
+lv_obj_t *DisplayManager::peak_markers_l[numVolumeArcs] = {nullptr};
+lv_obj_t *DisplayManager::peak_markers_r[numVolumeArcs] = {nullptr};
 lv_obj_t *DisplayManager::label_db = nullptr;
+RoutingMatrix DisplayManager::routingMatrix;
+lv_obj_t *DisplayManager::matrix_page_label = nullptr;
+const StripMap *DisplayManager::stripMap = &StripMap::defaults();
 
 static QueueHandle_t s_cmdQueue = nullptr;
+static QueueHandle_t s_predictionQueue = nullptr;
+
+struct VolumePrediction
+{
+    uint8_t strip;
+    int16_t gainDb100;
+};
 static TaskHandle_t s_displayTaskHandle = nullptr;
+static std::atomic<uint8_t> s_wakeReasons{0};
 
 DisplayManager::DisplayManager()
 {
@@ -38,24 +56,32 @@ void DisplayManager::begin(PowerManager *powerMgr, byte lastIPD)
     lv_init();
     /* Set the tick callback */
     lv_tick_set_cb(my_tick);
-    /* Initialize the display driver (TFT_eSPI backend helper) */
-    auto disp = lv_tft_espi_create(240, 240, lv_buffer, BUF_SIZE);
+    /* Initialize the display driver: two DMA stripe buffers, rendering overlaps the SPI transfer */
+    auto disp = displayDriver.create(tft, TFTSIZE, TFTSIZE);
     lv_display_set_rotation(disp, LV_DISPLAY_ROTATION_180);
 
     ui_init();
     setupLvglVaribleReferences();
 
+    // Meter ballistics (and the render gate on them) only for the channels the level arcs draw
+    uint64_t meterChannels = 0;
+    for (uint8_t slot = 0; slot < STRIP_MAP_SLOTS; slot++)
+        for (uint8_t channel : {stripMap->levelLeft[slot], stripMap->levelRight[slot]})
+            if (channel < METER_CHANNELS)
+                meterChannels |= 1ull << channel;
+    meterEngine.setChannels(meterChannels);
+
     touch.begin();
     lv_timer_handler(); // Update the UI
 
     // Register LVGL input device for the CST816S touchscreen (LVGL v9 API)
     {
-        lv_indev_t *touch_indev = lv_indev_create();
-        if (touch_indev)
+        touchIndev = lv_indev_create();
+        if (touchIndev)
         {
-            lv_indev_set_type(touch_indev, LV_INDEV_TYPE_POINTER);
-            lv_indev_set_read_cb(touch_indev, lv_touch_read);
-            lv_indev_set_display(touch_indev, disp);
+            lv_indev_set_type(touchIndev, LV_INDEV_TYPE_POINTER);
+            lv_indev_set_read_cb(touchIndev, lv_touch_read);
+            lv_indev_set_display(touchIndev, disp);
         }
     }
 
@@ -65,6 +91,8 @@ void DisplayManager::begin(PowerManager *powerMgr, byte lastIPD)
     // Run the UI functionality in a dedicated task
     if (!s_cmdQueue)
         s_cmdQueue = xQueueCreate(16, sizeof(NetworkCommand)); // capacity 16
+    if (!s_predictionQueue)
+        s_predictionQueue = xQueueCreate(8, sizeof(VolumePrediction));
     if (!s_displayTaskHandle)
     {
         xTaskCreatePinnedToCore(
@@ -86,9 +114,13 @@ void DisplayManager::begin(PowerManager *powerMgr, byte lastIPD)
                     // Only call LVGL APIs from this task
                     mgr->update(displayOn, lowFramerate);
 
-                    // Dynamic refresh rate: 60Hz when active, 2Hz when idle
+                    // Frame cap: 60Hz when active, 4Hz in low-power mode; wake-ups arriving meanwhile stay pending
                     TickType_t delay = lowFramerate ? pdMS_TO_TICKS(250) : pdMS_TO_TICKS(16);
                     vTaskDelay(delay);
+
+                    // Nothing moving on screen: sleep until requestFrame() or the next touch poll
+                    if (!mgr->isRenderActive())
+                        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TOUCH_POLL_MS));
                 }
             },
             "DisplayTask",
@@ -123,20 +155,37 @@ void DisplayManager::update(byte displayShouldBeOn, byte reducePowerMode)
     //     fpsLastMs = now;
     // }
 
+#ifdef DISPLAY_FLUSH_STATS
+    static unsigned long flushStatsLastMs = 0;
+    if (millis() - flushStatsLastMs >= 5000)
+    {
+        FlushStats fs = displayDriver.getFlushStats();
+        if (fs.flushes)
+            Serial.printf("Flush: %u stripes, %llu px (%u frames, max %u px/frame), render %llu us, DMA wait %llu us (max %u), transfer ~%u us\n",
+                          fs.flushes, fs.pixels, fs.frames, fs.maxFramePixels, fs.renderUs, fs.waitUs, fs.maxWaitUs,
+                          DmaDisplayDriver::estimatedTransferUs(fs.pixels));
+        displayDriver.resetFlushStats();
+        flushStatsLastMs = millis();
+    }
+#endif
+
     // Handle display sleep/wake based on power manager state
     // Use instance member to persist display state between calls
     if (displayShouldBeOn && !wasDisplayOn)
     {
         // Resume: turn display back on
+        displayDriver.waitIdle();
         tft.writecommand(0x29); // TFT_DISPON: turn on display
         tft.writecommand(0x11); // TFT_SLPOUT: exit sleep mode
         Serial.printf("DisplayShouldBeOn: %d. WasDisplayOn: %d\n", displayShouldBeOn, wasDisplayOn);
         Serial.println("Display ON");
         wasDisplayOn = true;
+        renderActiveUntil = millis() + ACTIVE_HOLD_MS; // repaint whatever changed while it was off
     }
     else if (!displayShouldBeOn && wasDisplayOn)
     {
         // Shutdown: turn display off
+        displayDriver.waitIdle();
         tft.writecommand(0x10); // TFT_SLPIN: enter sleep mode
         tft.writecommand(0x28); // TFT_DISPOFF: turn off display
         Serial.printf("DisplayShouldBeOn: %d. WasDisplayOn: %d\n", displayShouldBeOn, wasDisplayOn);
@@ -151,6 +200,40 @@ void DisplayManager::update(byte displayShouldBeOn, byte reducePowerMode)
         return;
     }
 
+    if (!hasSetupUSBSerial && millis() > 15000)
+    {
+        bool usbSerialEnabled = usbSerialPreferences.getBool("enabled", true);
+        setUSBSerialEnabled(usbSerialEnabled);
+        hasSetupUSBSerial = true;
+    }
+
+    // Render only while something is changing; idle wake-ups just poll the touch controller
+    unsigned long now = millis();
+    bool woken = s_wakeReasons.exchange(0) != 0;
+    if (!woken && !isRenderActive() && touchIndev)
+    {
+        long touchBefore = lastTouchTime;
+        lv_indev_read(touchIndev);
+        woken = lastTouchTime != touchBefore;
+    }
+    if (woken || lv_anim_count_running() > 0 || now - lastTouchTime < ACTIVE_HOLD_MS || predictedState.inFlightCount() > 0 || !meterEngine.isSettled())
+        renderActiveUntil = now + ACTIVE_HOLD_MS;
+    if (!isRenderActive())
+        return;
+
+    PROFILE_BEGIN_FRAME();
+
+    // Pick up the newest RT packet; it stays valid for this whole frame, including LVGL event callbacks
+    if (packetSource)
+    {
+        const RTSnapshot *snapshot = packetSource->acquire();
+        latestVoicemeeterData = &snapshot->packet;
+        stateStamp = snapshot->regionStamp[RT_REGION_STATE];
+    }
+    applyPredictions();
+    if (meterSource)
+        meterEngine.update(*meterSource, now);
+
     // static lv_obj_t *lastLoadedScreen = nullptr;
     auto currentlyActiveScreen = lv_disp_get_scr_act(lv_display_get_default());
 
@@ -182,15 +265,20 @@ void DisplayManager::update(byte displayShouldBeOn, byte reducePowerMode)
         currentScreen = CONFIG;
     }
 
+    PROFILE_MARK(PROFILE_SYNC);
+
     // Depending on chosen screen, update relevant elements
     if (currentlyActiveScreen == ui_Monitor)
     {
         updateArcs();
-        updateOutputButtons(true);
+        PROFILE_MARK(PROFILE_ARCS);
+        updateOutputButtons();
+        PROFILE_MARK(PROFILE_BUTTONS);
     }
     else if (currentlyActiveScreen == ui_OutputMatrix)
     {
-        updateOutputButtons(false);
+        updateRoutingMatrix();
+        PROFILE_MARK(PROFILE_BUTTONS);
     }
     else if (currentlyActiveScreen == ui_Config)
     {
@@ -206,14 +294,12 @@ void DisplayManager::update(byte displayShouldBeOn, byte reducePowerMode)
         }
     }
 
+    PROFILE_MARK(PROFILE_SYNC); // label/bar updates of the other screens
+
     lv_timer_handler(); // Update the UI
+    PROFILE_MARK(PROFILE_RENDER);
+    PROFILE_END_FRAME();
     // powerManager->setDisplayReady(true);
-    if (!hasSetupUSBSerial && millis() > 15000)
-    {
-        bool usbSerialEnabled = usbSerialPreferences.getBool("enabled", true);
-        setUSBSerialEnabled(usbSerialEnabled);
-        hasSetupUSBSerial = true;
-    }
 }
 void DisplayManager::setUSBSerialEnabled(bool enabled)
 {
@@ -238,7 +324,18 @@ void DisplayManager::updateArcs()
     static int lastSelectedArc = -1;
     static float lastBatteryLevel = -1;
 
-    short outputLevels[numVolumeArcs * 2] = {getOutputLevel(10), getOutputLevel(11), getOutputLevel(18), getOutputLevel(19), getOutputLevel(26), getOutputLevel(27)};
+    static int lastPeakL[numVolumeArcs] = {-1, -1, -1};
+    static int lastPeakR[numVolumeArcs] = {-1, -1, -1};
+
+    short outputLevels[numVolumeArcs * 2];
+    short outputPeaks[numVolumeArcs * 2];
+    for (int i = 0; i < numVolumeArcs; ++i)
+    {
+        outputLevels[i * 2] = getOutputLevel(stripMap->levelLeft[i]);
+        outputLevels[i * 2 + 1] = getOutputLevel(stripMap->levelRight[i]);
+        outputPeaks[i * 2] = getOutputPeak(stripMap->levelLeft[i]);
+        outputPeaks[i * 2 + 1] = getOutputPeak(stripMap->levelRight[i]);
+    }
 
     for (int i = 0; i < numVolumeArcs; ++i)
     {
@@ -246,27 +343,41 @@ void DisplayManager::updateArcs()
         if (!strip_arcs[i] || !level_arcs_l[i] || !level_arcs_r[i])
             continue;
 
-        int stripVal = getStripLevel(13 + i);
+        int stripVal = getStripLevel(stripMap->strip[i]);
         if (stripVal != lastStripValue[i])
         {
-            lv_arc_set_value(strip_arcs[i], stripVal);
+            ArcSectorUpdater::setValue(strip_arcs[i], stripVal);
             lastStripValue[i] = stripVal;
         }
 
         int valL = (outputLevels[i * 2] * stripVal / dbMinOffset);
         if (valL != lastLevelL[i])
         {
-            lv_arc_set_value(level_arcs_l[i], valL);
+            ArcSectorUpdater::setValue(level_arcs_l[i], valL);
             lastLevelL[i] = valL;
         }
 
         int valR = (outputLevels[i * 2 + 1] * stripVal / dbMinOffset);
         if (valR != lastLevelR[i])
         {
-            lv_arc_set_value(level_arcs_r[i], valR);
+            ArcSectorUpdater::setValue(level_arcs_r[i], valR);
             lastLevelR[i] = valR;
         }
 
+        int peakL = (outputPeaks[i * 2] * stripVal / dbMinOffset);
+        if (peakL != lastPeakL[i] && peak_markers_l[i])
+        {
+            setPeakMarker(peak_markers_l[i], level_arcs_l[i], peakL);
+            lastPeakL[i] = peakL;
+        }
+
+        int peakR = (outputPeaks[i * 2 + 1] * stripVal / dbMinOffset);
+        if (peakR != lastPeakR[i] && peak_markers_r[i])
+        {
+            setPeakMarker(peak_markers_r[i], level_arcs_r[i], peakR);
+            lastPeakR[i] = peakR;
+        }
+
         // Only adjust colors/styles if selection changed
         if (selectedVolumeArc != lastSelectedArc)
         {
@@ -280,7 +391,7 @@ void DisplayManager::updateArcs()
     lastSelectedArc = selectedVolumeArc;
 
     // Update dB label
-    int dbValue = getStripLevel(13 + selectedVolumeArc);
+    int dbValue = getStripLevel(stripMap->strip[selectedVolumeArc]); // the strip the knob turns
     // Format dB into the persistent buffer and update the label only if text changed.
     char tmp[16];
     float db = convertLevelToDb(dbValue);
@@ -300,35 +411,98 @@ void DisplayManager::updateArcs()
     }
 }
 
-void DisplayManager::updateOutputButtons(bool previewButtons)
+void DisplayManager::getStripStates(uint32_t states[StateChanges::NUM_CHANNELS])
 {
-    // get the states for the output buttons
-    bool buttonStates[numBuses * numOutputs];
+    for (uint8_t strip = 0; strip < StateChanges::NUM_CHANNELS; ++strip)
+        states[strip] = predictedState.stripState(*latestVoicemeeterData, strip);
+}
+
+// False while neither the packet's state region nor a routing prediction changed since seen was taken
+bool DisplayManager::routingChangedSince(RoutingSeen &seen)
+{
+    uint32_t revision = predictedState.getRoutingRevision();
+    if (seen.valid && seen.stateStamp == stateStamp && seen.routingRevision == revision)
+        return false;
+    seen.valid = true;
+    seen.stateStamp = stateStamp;
+    seen.routingRevision = revision;
+    return true;
+}
+
+// Monitor preview of the output grid: one row of buses per mapped strip
+void DisplayManager::updateOutputButtons()
+{
+    if (!routingChangedSince(previewSeen))
+        return;
+    uint32_t states[StateChanges::NUM_CHANNELS];
+    getStripStates(states);
+    const StateChanges &changes = previewDiff.update(states);
+    if (!changes.strips)
+        return;
+
+    // only touch buttons whose routing bit flipped; add/clear_state restyles the button
+    lv_obj_t *btnContainer = ui_OutputButtonPreviewContainer;
+    auto childCount = lv_obj_get_child_count(btnContainer);
     for (int i = 0; i < numBuses; ++i)
     {
-        for (int j = 0; j < numOutputs; ++j)
+        uint8_t strip = stripMap->strip[i];
+        if (!(changes.strips & (1 << strip)))
+            continue;
+        for (int j = 0; j < numOutputs && i * numOutputs + j < (int)childCount; ++j)
         {
-            buttonStates[i * numOutputs + j] = getStripOutputEnabled(5 + i, j);
+            if (!changes.stripChanged(strip, stripMap->busBit[i][j]))
+                continue;
+            auto btn = lv_obj_get_child(btnContainer, i * numOutputs + j);
+            if (states[strip] & stripMap->busBit[i][j])
+                lv_obj_add_state(btn, LV_STATE_CHECKED);
+            else
+                lv_obj_clear_state(btn, LV_STATE_CHECKED);
         }
     }
-    // get the button container
-    lv_obj_t *btnContainer = ui_OutputButtonContainer;
-    if (previewButtons)
-        btnContainer = ui_OutputButtonPreviewContainer;
+}
 
-    // iterate through buttons and update their states
-    auto childCount = lv_obj_get_child_count(btnContainer);
-    for (short i = 0; i < childCount; i++)
+void DisplayManager::updateRoutingMatrix()
+{
+    if (!routingChangedSince(matrixSeen) && routingMatrix.isBound())
+        return;
+    uint32_t states[StateChanges::NUM_CHANNELS];
+    getStripStates(states);
+    const StateChanges &changes = matrixDiff.update(states);
+    if (!changes.strips && routingMatrix.isBound())
+        return;
+
+    uint8_t routing[RoutingMatrix::NUM_STRIPS];
+    for (uint8_t strip = 0; strip < RoutingMatrix::NUM_STRIPS; ++strip)
+        routing[strip] = RoutingMatrix::routingBits(states[strip]);
+
+    // only the pool buttons whose bus bit flipped (or all of them after a page change)
+    uint16_t changed = routingMatrix.applyRouting(routing);
+    for (uint8_t cell = 0; changed; ++cell, changed >>= 1)
     {
-        auto btn = lv_obj_get_child(btnContainer, i);
-        bool enabled = buttonStates[i];
-        if (enabled)
+        if (!(changed & 1))
+            continue;
+        lv_obj_t *btn = lv_obj_get_child(ui_OutputButtonContainer, cell);
+        if (routingMatrix.cellEnabled(cell))
             lv_obj_add_state(btn, LV_STATE_CHECKED);
         else
             lv_obj_clear_state(btn, LV_STATE_CHECKED);
     }
 }
 
+// Point the pooled buttons at the cells of the current page
+void DisplayManager::bindRoutingPage()
+{
+    for (uint8_t cell = 0; cell < RoutingMatrix::POOL_SIZE; ++cell)
+    {
+        lv_obj_t *label = lv_obj_get_child(lv_obj_get_child(ui_OutputButtonContainer, cell), 0);
+        if (label)
+            lv_label_set_text_static(label, RoutingMatrix::busName(routingMatrix.cellBus(cell)));
+    }
+    // Voicemeeter numbers strips from 1 in its own UI
+    uint8_t first = routingMatrix.firstStrip() + 1;
+    lv_label_set_text_fmt(matrix_page_label, "Strips %u-%u", first, first + RoutingMatrix::POOL_COLUMNS - 1);
+}
+
 void DisplayManager::setupLvglVaribleReferences()
 { // assign UI arc widgets to the pre-declared arrays
     strip_arcs[0] = ui_LevelArc1;
@@ -340,17 +514,41 @@ void DisplayManager::setupLvglVaribleReferences()
     level_arcs_r[0] = ui_MonitorArcR1;
     level_arcs_r[1] = ui_MonitorArcR2;
     level_arcs_r[2] = ui_MonitorArcR3;
+    for (int i = 0; i < numVolumeArcs; ++i)
+    {
+        peak_markers_l[i] = createPeakMarker(level_arcs_l[i]);
+        peak_markers_r[i] = createPeakMarker(level_arcs_r[i]);
+    }
+    // Fixed ring geometry: rasterize the ring edges once, draw every arc as a masked fill
+    lv_obj_t *monitorArcs[] = {strip_arcs[0], strip_arcs[1], strip_arcs[2], level_arcs_l[0], level_arcs_l[1], level_arcs_l[2],
+                               level_arcs_r[0], level_arcs_r[1], level_arcs_r[2], peak_markers_l[0], peak_markers_l[1],
+                               peak_markers_l[2], peak_markers_r[0], peak_markers_r[1], peak_markers_r[2]};
+    for (lv_obj_t *arc : monitorArcs)
+        if (!RingMaskCache::attach(arc))
+            Serial.println("Ring cache full, arc left to LVGL");
 
     // get the button container
     auto btnContainer = ui_OutputButtonContainer;
     // iterate through buttons and create callbacks
     auto childCount = lv_obj_get_child_count(btnContainer);
+    if (childCount != RoutingMatrix::POOL_SIZE)
+        Serial.println("Output matrix button count does not match the routing pool");
     for (short i = 0; i < childCount; i++)
     {
         auto btn = lv_obj_get_child(btnContainer, i);
         lv_obj_add_event_cb(btn, output_btn_event_cb, LV_EVENT_CLICKED, this);
     }
 
+    // The grid pages over all strips and buses; open it on the first mapped strip
+    routingMatrix = RoutingMatrix(stripMap->strip[0]);
+    matrix_page_label = lv_label_create(ui_OutputMatrix);
+    lv_obj_set_align(matrix_page_label, LV_ALIGN_TOP_MID);
+    lv_obj_set_y(matrix_page_label, 4);
+    lv_obj_set_style_text_color(matrix_page_label, lv_color_hex(0x70C399), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(matrix_page_label, &lv_font_montserrat_14, LV_PART_MAIN | LV_STATE_DEFAULT);
+    bindRoutingPage();
+    lv_obj_add_event_cb(ui_OutputMatrix, ui_event_OutputMatrix_Callback, LV_EVENT_GESTURE, NULL);
+
     lv_obj_add_event_cb(ui_Monitor, ui_event_Monitor_Callback, LV_EVENT_GESTURE, this);
     lv_obj_add_event_cb(ui_MonitorIncrementSelectedChannel, ui_event_Monitor_Callback, LV_EVENT_CLICKED, NULL);
     lv_obj_add_event_cb(ui_MonitorDecrementSelectedChannel, ui_event_Monitor_Callback, LV_EVENT_CLICKED, NULL);
@@ -388,6 +586,42 @@ void DisplayManager::setupLvglVaribleReferences()
     Serial.println("LVGL initialized");
 }
 
+// A short arc segment drawn on top of a level arc, at the same radius and width
+lv_obj_t *DisplayManager::createPeakMarker(lv_obj_t *levelArc)
+{
+    lv_obj_t *marker = lv_arc_create(lv_obj_get_parent(levelArc));
+    lv_obj_set_size(marker, lv_obj_get_width(levelArc), lv_obj_get_height(levelArc));
+    lv_obj_set_align(marker, LV_ALIGN_CENTER);
+    lv_obj_remove_flag(marker, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_PRESS_LOCK | LV_OBJ_FLAG_CLICK_FOCUSABLE);
+    lv_obj_set_style_arc_width(marker, 0, LV_PART_MAIN);
+    lv_obj_set_style_arc_color(marker, lv_color_hex(0xFFFFFF), LV_PART_INDICATOR);
+    lv_obj_set_style_arc_width(marker, lv_obj_get_style_arc_width(levelArc, LV_PART_INDICATOR), LV_PART_INDICATOR);
+    lv_obj_set_style_arc_rounded(marker, false, LV_PART_INDICATOR);
+    lv_obj_set_style_bg_opa(marker, 0, LV_PART_KNOB);
+    lv_obj_add_flag(marker, LV_OBJ_FLAG_HIDDEN);
+    return marker;
+}
+
+void DisplayManager::setPeakMarker(lv_obj_t *marker, lv_obj_t *levelArc, int value)
+{
+    if (value <= 0)
+    {
+        lv_obj_add_flag(marker, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    // Map the value onto the level arc's background sweep, then draw a 3 degree tick there
+    int start = lv_arc_get_bg_angle_start(levelArc);
+    int sweep = ((int)lv_arc_get_bg_angle_end(levelArc) - start + 360) % 360;
+    int angle = start + sweep * min(value, dbMinOffset) / dbMinOffset;
+    if (lv_obj_has_flag(marker, LV_OBJ_FLAG_HIDDEN))
+    {
+        lv_arc_set_angles(marker, (angle + 358) % 360, (angle + 1) % 360);
+        lv_obj_remove_flag(marker, LV_OBJ_FLAG_HIDDEN); // invalidates the whole marker once
+        return;
+    }
+    ArcSectorUpdater::setAngles(marker, (angle + 358) % 360, (angle + 1) % 360);
+}
+
 void DisplayManager::ui_event_IP_Change_Callback(lv_event_t *e)
 {
     lv_event_code_t event_code = lv_event_get_code(e);
@@ -401,7 +635,9 @@ void DisplayManager::ui_event_IP_Change_Callback(lv_event_t *e)
         if (lastIPDigits == self->lastIPDigit)
             return;
 
-        self->sendCommandString(NetworkCommandType::SET_IP, String(lastIPDigits));
+        VBANCommandString<4> digits;
+        digits.integer(lastIPDigits);
+        self->sendCommandString(NetworkCommandType::SET_IP, digits.c_str());
     }
 }
 
@@ -443,28 +679,37 @@ void DisplayManager::ui_event_Monitor_Callback(lv_event_t *e)
 }
 
 // Helper to find a button index from object pointer
-bool DisplayManager::find_output_button(lv_obj_t *btn, int &busIdx, int &outIdx)
+int DisplayManager::find_output_button(lv_obj_t *btn)
 {
-    auto btnContainer = ui_OutputButtonContainer;
-    auto buttonCount = lv_obj_get_child_count(btnContainer);
+    if (lv_obj_get_parent(btn) != ui_OutputButtonContainer)
+        return -1;
+    int cell = lv_obj_get_index(btn);
+    return cell < RoutingMatrix::POOL_SIZE ? cell : -1;
+}
 
-    for (int i = 0; i < numBuses; ++i)
+// Swipes page the routing matrix; swiping down is left to SquareLine's return to the Monitor
+void DisplayManager::ui_event_OutputMatrix_Callback(lv_event_t *e)
+{
+    bool moved = false;
+    switch (lv_indev_get_gesture_dir(lv_indev_active()))
     {
-        for (int j = 0; j < numOutputs; ++j)
-        {
-            if (i * numOutputs + j >= buttonCount)
-                return false;
-            auto btnCandidate = lv_obj_get_child(btnContainer, i * numOutputs + j);
-
-            if (btnCandidate == btn)
-            {
-                busIdx = i;
-                outIdx = j;
-                return true;
-            }
-        }
+    case LV_DIR_LEFT:
+        moved = routingMatrix.scrollStrips(1);
+        break;
+    case LV_DIR_RIGHT:
+        moved = routingMatrix.scrollStrips(-1);
+        break;
+    case LV_DIR_TOP:
+        moved = routingMatrix.scrollBuses(1);
+        break;
+    default:
+        break;
+    }
+    if (moved)
+    {
+        bindRoutingPage();
+        requestFrame(WAKE_INPUT);
     }
-    return false;
 }
 
 // Button event handler for outputs grid
@@ -476,15 +721,20 @@ void DisplayManager::output_btn_event_cb(lv_event_t *e)
         return;
 
     lv_obj_t *btn = (lv_obj_t *)lv_event_get_target(e);
-    int busIdx = -1, outIdx = -1;
-    if (!find_output_button(btn, busIdx, outIdx))
+    int cell = find_output_button(btn);
+    if (cell < 0)
         return;
 
     // toggle state
-    bool newState = !getStripOutputEnabled(5 + busIdx, outIdx);
-    String commandString = "Strip[" + String(5 + busIdx) + "].A" + String(outIdx + 1) + " = " + String(newState);
-    Serial.println(commandString);
-    self->sendCommandString(NetworkCommandType::SEND_VBAN_COMMAND, commandString);
+    uint8_t strip = routingMatrix.cellStrip(cell);
+    uint8_t bus = routingMatrix.cellBus(cell);
+    uint8_t routing = RoutingMatrix::routingBits(predictedState.stripState(*latestVoicemeeterData, strip));
+    bool newState = !(routing & (1 << bus));
+    predictedState.predictRouting(strip, StripMap::busStateBit(bus), newState, latestVoicemeeterData->frameCounter, millis());
+    VBANCommandString<sizeof(NetworkCommand::payload)> commandString;
+    commandString.stripBus(strip, bus, newState);
+    Serial.println(commandString.c_str());
+    self->sendCommandString(NetworkCommandType::SEND_VBAN_COMMAND, commandString.c_str());
 }
 
 // Wrapper with generic pointers to avoid parser issues with forward typedefs in some toolchains.
@@ -513,12 +763,11 @@ void DisplayManager::lv_touch_read(lv_indev_t *indev, lv_indev_data_t *data)
     }
 }
 
-void DisplayManager::showLatestVoicemeeterData(const tagVBAN_VMRT_PACKET &packet)
-{
-    latestVoicemeeterData = packet;
-}
 void DisplayManager::showLatestBatteryData(float battPerc, int chgTime, float battVolt)
 {
+    // Compare at the precision the labels print, so sensor noise does not keep the display awake
+    if (lroundf(battPerc * 100) != lroundf(batteryPercentage * 100) || chgTime != chargeTime || lroundf(battVolt * 100) != lroundf(batteryVoltage * 100))
+        requestFrame(WAKE_STATE);
     batteryPercentage = battPerc;
     chargeTime = chgTime;
     batteryVoltage = battVolt;
@@ -526,14 +775,23 @@ void DisplayManager::showLatestBatteryData(float battPerc, int chgTime, float ba
 
 void DisplayManager::setConnectionStatus(bool connected)
 {
+    if (connected != connectionStatus)
+        requestFrame(WAKE_STATE);
     connectionStatus = connected;
 }
+
+void DisplayManager::requestFrame(uint8_t reasons)
+{
+    s_wakeReasons.fetch_or(reasons);
+    if (s_displayTaskHandle)
+        xTaskNotifyGive(s_displayTaskHandle);
+}
 void DisplayManager::setIsInteracting(bool interacting)
 {
     isInteracting = interacting;
 }
 
-void DisplayManager::sendCommandString(NetworkCommandType type, const String &command)
+void DisplayManager::sendCommandString(NetworkCommandType type, const char *command)
 {
     if (!s_cmdQueue)
     { /* fallback: ignore or use mutex */
@@ -541,35 +799,52 @@ void DisplayManager::sendCommandString(NetworkCommandType type, const String &co
     }
     NetworkCommand item;
     item.type = type;
-    strncpy(item.payload, command.c_str(), sizeof(item.payload));
+    strncpy(item.payload, command, sizeof(item.payload));
     item.payload[sizeof(item.payload) - 1] = '\0';
     xQueueSend(s_cmdQueue, &item, 0); // non-blocking; increase timeout if needed
 }
 
-std::vector<NetworkCommand> DisplayManager::getIssuedCommands()
+void DisplayManager::predictVolume(uint8_t channel, int16_t gainDb100)
 {
-    std::vector<NetworkCommand> out;
-    if (!s_cmdQueue)
-        return out;
-    NetworkCommand item;
-    while (xQueueReceive(s_cmdQueue, &item, 0) == pdTRUE)
-    {
-        out.emplace_back(item);
-    }
-    return out;
+    if (!s_predictionQueue)
+        return;
+    VolumePrediction item = {stripMap->strip[channel], gainDb100};
+    xQueueSend(s_predictionQueue, &item, 0);
+    requestFrame(WAKE_INPUT);
+}
+
+// Runs on the display task: take predictions from other tasks, then reconcile everything against the newest packet
+void DisplayManager::applyPredictions()
+{
+    VolumePrediction item;
+    while (s_predictionQueue && xQueueReceive(s_predictionQueue, &item, 0) == pdTRUE)
+        predictedState.predictGain(item.strip, item.gainDb100, latestVoicemeeterData->frameCounter, millis());
+    predictedState.reconcile(*latestVoicemeeterData, millis());
+}
+
+bool DisplayManager::takeIssuedCommand(NetworkCommand &command)
+{
+    return s_cmdQueue && xQueueReceive(s_cmdQueue, &command, 0) == pdTRUE;
 }
 
 // return number between 0 and 6000
 short DisplayManager::getOutputLevel(byte channel)
 {
-    short val = latestVoicemeeterData.inputLeveldB100[channel] + dbMinOffset;
+    short val = meterEngine.level(channel) + dbMinOffset;
+    if (val < 0)
+        val = 0;
+    return val;
+}
+short DisplayManager::getOutputPeak(byte channel)
+{
+    short val = meterEngine.peak(channel) + dbMinOffset;
     if (val < 0)
         val = 0;
     return val;
 }
-short DisplayManager::getStripLevel(byte channel)
+short DisplayManager::getStripLevel(byte strip)
 {
-    short val = latestVoicemeeterData.stripGaindB100Layer1[channel] + dbMinOffset;
+    short val = predictedState.stripGain(*latestVoicemeeterData, strip) + dbMinOffset;
     if (val < 0)
         val = 0;
     return val;
@@ -590,26 +865,6 @@ float DisplayManager::convertLevelToDb(int level)
     return (static_cast<float>(level) / 100.0f) - 60.0f;
 }
 
-bool DisplayManager::getStripOutputEnabled(byte stripNo, byte outputNo)
-{
-    unsigned long stripState = latestVoicemeeterData.stripState[stripNo];
-    switch (outputNo)
-    {
-    case 0:
-        return stripState & VMRTSTATE_MODE_BUSA1;
-    case 1:
-        return stripState & VMRTSTATE_MODE_BUSA2;
-    case 2:
-        return stripState & VMRTSTATE_MODE_BUSA3;
-    case 3:
-        return stripState & VMRTSTATE_MODE_BUSA4;
-    case 4:
-        return stripState & VMRTSTATE_MODE_BUSA5;
-    default:
-        return false;
-    }
-}
-
 void DisplayManager::showIpAddress(uint32_t address)
 {
     String ipStr =
@@ -0,0 +1,120 @@
+#include "DmaDisplayDriver.h"
+#include <esp_heap_caps.h>
+#include "FrameProfiler.h"
+
+#ifndef SPI_FREQUENCY
+#define SPI_FREQUENCY 40000000
+#endif
+
+lv_display_t *DmaDisplayDriver::create(TFT_eSPI &panel, int32_t width, int32_t height)
+{
+    tft = &panel;
+    tft->begin();
+    tft->setRotation(0);
+    tft->setSwapBytes(true); // LVGL renders native-endian RGB565, swapped in place before the DMA
+    tft->initDMA();
+    tft->startWrite(); // keep the SPI bus for the DMA transfers; writecommand() nests inside it
+
+    size_t bufBytes = width * BUF_LINES * sizeof(uint16_t);
+    buffers[0] = (uint16_t *)heap_caps_malloc(bufBytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    buffers[1] = (uint16_t *)heap_caps_malloc(bufBytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!buffers[0])
+    {
+        buffers[0] = buffers[1];
+        buffers[1] = nullptr;
+    }
+    if (!buffers[0])
+    {
+        Serial.println("DMA display: no DMA-capable memory for the draw buffers");
+        return nullptr;
+    }
+    doubleBuffered = buffers[1] != nullptr;
+    if (!doubleBuffered)
+        Serial.println("DMA display: only one buffer available, transfers will not overlap rendering");
+
+    lv_display_t *disp = lv_display_create(width, height);
+    lv_display_set_user_data(disp, this);
+    lv_display_set_flush_cb(disp, flush);
+    lv_display_set_buffers(disp, buffers[0], buffers[1], bufBytes, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_add_event_cb(disp, resolutionChanged, LV_EVENT_RESOLUTION_CHANGED, this);
+    lv_display_add_event_cb(disp, refreshStarted, LV_EVENT_REFR_START, this);
+    lastReadyUs = micros();
+    return disp;
+}
+
+void DmaDisplayDriver::waitIdle()
+{
+    if (tft)
+        tft->dmaWait();
+}
+
+uint32_t DmaDisplayDriver::estimatedTransferUs(uint64_t pixels)
+{
+    return (uint32_t)(pixels * 16 * 1000000ULL / SPI_FREQUENCY);
+}
+
+void DmaDisplayDriver::flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    DmaDisplayDriver *drv = static_cast<DmaDisplayDriver *>(lv_display_get_user_data(disp));
+    unsigned long start = micros();
+    drv->stats.renderUs += start - drv->lastReadyUs;
+
+    // The address window cannot change while the previous stripe is still being sent
+    drv->tft->dmaWait();
+    unsigned long waited = micros() - start;
+    drv->stats.waitUs += waited;
+    if (waited > drv->stats.maxWaitUs)
+        drv->stats.maxWaitUs = waited;
+
+    uint32_t w = lv_area_get_width(area);
+    uint32_t h = lv_area_get_height(area);
+    drv->tft->setAddrWindow(area->x1, area->y1, w, h);
+    drv->tft->pushPixelsDMA((uint16_t *)px_map, w * h);
+    drv->stats.flushes++;
+    drv->stats.pixels += w * h;
+    drv->framePixels += w * h;
+    PROFILE_ADD(PROFILE_PIXELS, w * h);
+    if (lv_display_flush_is_last(disp))
+    {
+        drv->stats.frames++;
+        if (drv->framePixels > drv->stats.maxFramePixels)
+            drv->stats.maxFramePixels = drv->framePixels;
+        drv->framePixels = 0;
+    }
+
+    if (!drv->doubleBuffered)
+        drv->tft->dmaWait(); // LVGL would draw into the buffer being sent
+
+    drv->lastReadyUs = micros();
+    PROFILE_ADD(PROFILE_FLUSH, drv->lastReadyUs - start);
+    lv_display_flush_ready(disp);
+}
+
+void DmaDisplayDriver::refreshStarted(lv_event_t *e)
+{
+    // Idle time between frames is not rendering
+    static_cast<DmaDisplayDriver *>(lv_event_get_user_data(e))->lastReadyUs = micros();
+}
+
+void DmaDisplayDriver::resolutionChanged(lv_event_t *e)
+{
+    DmaDisplayDriver *drv = static_cast<DmaDisplayDriver *>(lv_event_get_user_data(e));
+    lv_display_t *disp = static_cast<lv_display_t *>(lv_event_get_current_target(e));
+    drv->waitIdle();
+    // Same mapping as LVGL's TFT_eSPI driver: let the panel rotate instead of LVGL
+    switch (lv_display_get_rotation(disp))
+    {
+    case LV_DISPLAY_ROTATION_0:
+        drv->tft->setRotation(0);
+        break;
+    case LV_DISPLAY_ROTATION_90:
+        drv->tft->setRotation(1);
+        break;
+    case LV_DISPLAY_ROTATION_180:
+        drv->tft->setRotation(2);
+        break;
+    case LV_DISPLAY_ROTATION_270:
+        drv->tft->setRotation(3);
+        break;
+    }
+}
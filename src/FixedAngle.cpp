@@ -0,0 +1,60 @@
+#include "FixedAngle.h"
+
+static const uint8_t ATAN_SEGMENTS_LOG2 = 6;
+static const uint8_t ATAN_SEGMENTS = 1 << ATAN_SEGMENTS_LOG2;
+static const uint8_t RATIO_FRACTION_BITS = 16 - ATAN_SEGMENTS_LOG2;
+
+// atan(i / 64) for i = 0..64, in Q15 half turns (8192 == 45 degrees)
+static const uint16_t ATAN_TABLE[ATAN_SEGMENTS + 1] = {
+    0, 163, 326, 489, 651, 813, 975, 1136,
+    1297, 1457, 1617, 1775, 1933, 2090, 2246, 2401,
+    2555, 2708, 2860, 3010, 3159, 3307, 3453, 3599,
+    3742, 3884, 4025, 4164, 4302, 4438, 4572, 4705,
+    4836, 4966, 5094, 5220, 5344, 5467, 5589, 5708,
+    5826, 5943, 6058, 6171, 6282, 6392, 6500, 6607,
+    6712, 6815, 6917, 7018, 7117, 7214, 7310, 7405,
+    7498, 7589, 7679, 7768, 7856, 7942, 8026, 8110,
+    8192,
+};
+
+angle_q15_t fixedAtan2(int32_t y, int32_t x)
+{
+    if (x == 0 && y == 0)
+        return 0;
+
+    uint32_t ax = x < 0 ? -static_cast<uint32_t>(x) : x;
+    uint32_t ay = y < 0 ? -static_cast<uint32_t>(y) : y;
+
+    // First octant: ratio = min / max in [0, 1] as Q16
+    bool steep = ay > ax;
+    uint32_t num = steep ? ax : ay;
+    uint32_t den = steep ? ay : ax;
+    while (num > 0xFFFF) // keep num << 16 inside 32 bits for inputs wider than int16
+    {
+        num >>= 1;
+        den >>= 1;
+    }
+    uint32_t ratio = (num << 16) / den;
+
+    uint32_t index = ratio >> RATIO_FRACTION_BITS;
+    uint32_t angle;
+    if (index >= ATAN_SEGMENTS)
+    {
+        angle = ATAN_TABLE[ATAN_SEGMENTS];
+    }
+    else
+    {
+        uint32_t frac = ratio & ((1u << RATIO_FRACTION_BITS) - 1);
+        uint32_t step = ATAN_TABLE[index + 1] - ATAN_TABLE[index];
+        angle = ATAN_TABLE[index] + ((step * frac + (1u << (RATIO_FRACTION_BITS - 1))) >> RATIO_FRACTION_BITS);
+    }
+
+    // Unfold the octant back into the full circle
+    if (steep)
+        angle = ANGLE_Q15_HALF_TURN / 2 - angle;
+    if (x < 0)
+        angle = ANGLE_Q15_HALF_TURN - angle;
+    if (y < 0)
+        angle = -angle;
+    return static_cast<angle_q15_t>(static_cast<uint16_t>(angle)); // +180 wraps to -180, same direction
+}
@@ -0,0 +1,105 @@
+#include "FrameProfiler.h"
+
+#ifdef FRAME_PROFILER
+
+#include <algorithm>
+
+FrameProfiler frameProfiler;
+
+static const char *const PHASE_NAMES[NUM_PROFILE_PHASES] = {"sync", "arcs", "buttons", "render", "flush", "frame", "pixels"};
+
+static uint16_t saturate(uint32_t us)
+{
+    return us > 0xFFFF ? 0xFFFF : us;
+}
+
+void FrameProfiler::beginFrame()
+{
+    frameStartUs = lastMarkUs = micros();
+    for (uint8_t i = 0; i < NUM_PROFILE_PHASES; i++)
+        current[i] = 0;
+}
+
+void FrameProfiler::mark(ProfilePhase phase)
+{
+    uint32_t now = micros();
+    current[phase] += now - lastMarkUs;
+    lastMarkUs = now;
+}
+
+void FrameProfiler::add(ProfilePhase phase, uint32_t us)
+{
+    current[phase] += us;
+}
+
+void FrameProfiler::endFrame()
+{
+    uint32_t now = micros();
+    current[PROFILE_FRAME] = now - frameStartUs;
+    // Flushes happen inside lv_timer_handler; report them on their own
+    current[PROFILE_RENDER] = current[PROFILE_RENDER] > current[PROFILE_FLUSH] ? current[PROFILE_RENDER] - current[PROFILE_FLUSH] : 0;
+
+    uint16_t *slot = frames[frameCount % FRAMES];
+    for (uint8_t i = 0; i < NUM_PROFILE_PHASES; i++)
+        slot[i] = saturate(current[i]);
+    frameCount++;
+
+    DumpFormat format = pendingDump;
+    if (format != DUMP_NONE)
+    {
+        pendingDump = DUMP_NONE;
+        dump(format);
+    }
+}
+
+FrameProfiler::PhaseSummary FrameProfiler::summarize(uint8_t phase, uint16_t count) const
+{
+    uint16_t sorted[FRAMES];
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        sorted[i] = frames[i][phase];
+        sum += sorted[i];
+    }
+    std::sort(sorted, sorted + count);
+    PhaseSummary s;
+    s.min = sorted[0];
+    s.avg = sum / count;
+    s.p99 = sorted[(count * 99 - 1) / 100];
+    return s;
+}
+
+void FrameProfiler::dump(DumpFormat format)
+{
+    uint16_t count = frameCount < FRAMES ? frameCount : FRAMES;
+    uint32_t oldest = frameCount - count;
+
+    if (format == DUMP_BINARY)
+    {
+        uint8_t header[8] = {'F', 'P', 'R', 'F', FORMAT_VERSION, NUM_PROFILE_PHASES, (uint8_t)(count & 0xFF), (uint8_t)(count >> 8)};
+        Serial.write(header, sizeof(header));
+        for (uint32_t f = oldest; f < frameCount; f++)
+            Serial.write(reinterpret_cast<const uint8_t *>(frames[f % FRAMES]), sizeof(frames[0])); // both sides little endian
+        return;
+    }
+
+    Serial.printf("# frame profile, %u frames, us (pixels: count)\n", count);
+    if (count)
+    {
+        Serial.println("# phase,min,avg,p99");
+        for (uint8_t p = 0; p < NUM_PROFILE_PHASES; p++)
+        {
+            PhaseSummary s = summarize(p, count);
+            Serial.printf("# %s,%u,%u,%u\n", PHASE_NAMES[p], s.min, s.avg, s.p99);
+        }
+    }
+    Serial.println("frame,sync,arcs,buttons,render,flush,total,pixels");
+    for (uint32_t f = oldest; f < frameCount; f++)
+    {
+        const uint16_t *d = frames[f % FRAMES];
+        Serial.printf("%lu,%u,%u,%u,%u,%u,%u,%u\n", (unsigned long)f, d[PROFILE_SYNC], d[PROFILE_ARCS], d[PROFILE_BUTTONS], d[PROFILE_RENDER],
+                      d[PROFILE_FLUSH], d[PROFILE_FRAME], d[PROFILE_PIXELS]);
+    }
+}
+
+#endif
@@ -0,0 +1,68 @@
+#include "GainAccumulator.h"
+#include <math.h>
+
+GainAccumulator::GainAccumulator(unsigned long flushIntervalMs, unsigned long resyncAfterMs)
+    : flushIntervalMs(flushIntervalMs), resyncAfterMs(resyncAfterMs)
+{
+}
+
+void GainAccumulator::add(uint8_t strip, float dbDelta, int16_t reportedGainDb100, unsigned long now)
+{
+    if (strip >= NUM_STRIPS)
+        return;
+    StripAccumulator &s = strips[strip];
+    long delta = lroundf(dbDelta * 100.0f);
+    if (delta == 0)
+        return;
+
+    // After a quiet period Voicemeeter's own value is the truth (it may have been changed elsewhere)
+    bool idle = s.lastAddTime == 0 || now - s.lastAddTime > resyncAfterMs;
+    if (idle && !s.pending)
+    {
+        s.targetDb100 = reportedGainDb100;
+        s.sentDb100 = reportedGainDb100;
+        s.flushNow = true;
+    }
+
+    int8_t direction = delta > 0 ? 1 : -1;
+    if (s.lastDirection != 0 && direction != s.lastDirection)
+        s.flushNow = true;
+    s.lastDirection = direction;
+
+    long target = s.targetDb100 + delta;
+    if (target < GAIN_MIN_DB100)
+        target = GAIN_MIN_DB100;
+    if (target > GAIN_MAX_DB100)
+        target = GAIN_MAX_DB100;
+    s.targetDb100 = target;
+    s.pending = s.targetDb100 != s.sentDb100;
+    s.lastAddTime = now;
+}
+
+bool GainAccumulator::popCommand(unsigned long now, VBANCommandWriter &out)
+{
+    for (uint8_t i = 0; i < NUM_STRIPS; i++)
+    {
+        StripAccumulator &s = strips[i];
+        if (!s.pending)
+            continue;
+        if (!s.flushNow && now - s.lastFlushTime < flushIntervalMs)
+            continue;
+
+        out.stripGain(i, s.targetDb100 / 100.0f);
+        s.sentDb100 = s.targetDb100;
+        s.pending = false;
+        s.flushNow = false;
+        s.lastFlushTime = now;
+        return true;
+    }
+    return false;
+}
+
+bool GainAccumulator::hasPending() const
+{
+    for (uint8_t i = 0; i < NUM_STRIPS; i++)
+        if (strips[i].pending)
+            return true;
+    return false;
+}
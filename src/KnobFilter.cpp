@@ -0,0 +1,100 @@
+#include "KnobFilter.h"
+#include <math.h>
+
+static const float MAX_SAMPLE_GAP_S = 0.25f; // longer gaps restart the filter instead of smearing across them
+
+KnobFilter::KnobFilter(const KnobFilterConfig &config) : config(config)
+{
+}
+
+void KnobFilter::setConfig(const KnobFilterConfig &newConfig)
+{
+    config = newConfig;
+    reset();
+}
+
+void KnobFilter::reset()
+{
+    primed = false;
+    speedDps = 0;
+    rawAngle = filteredAngle = anchorAngle = 0;
+}
+
+float KnobFilter::smoothingFactor(float cutoffHz, float dt) const
+{
+    float tau = 1.0f / (2.0f * (float)M_PI * cutoffHz);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+float KnobFilter::velocityGain(float speed) const
+{
+    speed = fabsf(speed);
+    if (speed <= config.slowSpeedDps)
+        return config.slowGain;
+    if (speed >= config.fastSpeedDps)
+        return config.fastGain;
+    float t = (speed - config.slowSpeedDps) / (config.fastSpeedDps - config.slowSpeedDps);
+    return config.slowGain + t * (config.fastGain - config.slowGain);
+}
+
+void KnobFilter::addSample(uint32_t timestampUs, float angleDeltaDeg)
+{
+    rawAngle += angleDeltaDeg;
+    float dt = (timestampUs - lastTimestampUs) * 1e-6f;
+    lastTimestampUs = timestampUs;
+
+    if (!primed || dt <= 0 || dt > MAX_SAMPLE_GAP_S)
+    {
+        // Restart from here: keep the anchor offset so a pending backlash is not lost
+        float offset = anchorAngle - filteredAngle;
+        filteredAngle = rawAngle;
+        anchorAngle = rawAngle + offset;
+        speedDps = 0;
+        primed = true;
+        return;
+    }
+
+    float previous = filteredAngle;
+    switch (config.type)
+    {
+    case KnobFilterConfig::FILTER_ONE_EURO:
+    {
+        float rawSpeed = angleDeltaDeg / dt;
+        speedDps += smoothingFactor(config.speedCutoffHz, dt) * (rawSpeed - speedDps);
+        float cutoff = config.minCutoffHz + config.beta * fabsf(speedDps);
+        filteredAngle += smoothingFactor(cutoff, dt) * (rawAngle - filteredAngle);
+        break;
+    }
+    case KnobFilterConfig::FILTER_ALPHA_BETA:
+    {
+        float predicted = filteredAngle + speedDps * dt;
+        float residual = rawAngle - predicted;
+        filteredAngle = predicted + config.alpha * residual;
+        speedDps += config.betaAB * residual / dt;
+        break;
+    }
+    default:
+        filteredAngle = rawAngle;
+        speedDps = (filteredAngle - previous) / dt;
+        break;
+    }
+
+    // Backlash: the anchor only moves once the filtered angle pushes past the deadband
+    float moved = 0;
+    if (filteredAngle > anchorAngle + config.deadbandDeg)
+        moved = filteredAngle - config.deadbandDeg - anchorAngle;
+    else if (filteredAngle < anchorAngle - config.deadbandDeg)
+        moved = filteredAngle + config.deadbandDeg - anchorAngle;
+    if (moved == 0)
+        return;
+    anchorAngle += moved;
+
+    pendingDb100 += moved / config.degreesPerDb * velocityGain(speedDps) * 100.0f;
+}
+
+float KnobFilter::takeDb()
+{
+    float steps = truncf(pendingDb100);
+    pendingDb100 -= steps;
+    return steps / 100.0f;
+}
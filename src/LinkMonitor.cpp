@@ -0,0 +1,106 @@
+#include "LinkMonitor.h"
+
+bool LinkMonitor::update(unsigned long now, uint32_t packetCount, unsigned long lastPacketMs, bool wifiUp)
+{
+    // A short Wi-Fi drop is handled like any other silence, so the Monitor stays up through it
+    if (wifiUp && !wifiWasUp)
+    {
+        if (state == LINK_LOST)
+            enter(LINK_PROBING, now);
+        nextRegisterAt = now; // the registration may have lapsed while we were off the network
+        backoffMs = BACKOFF_FIRST_MS;
+    }
+    wifiWasUp = wifiUp;
+
+    if (packetCount != seenPackets)
+    {
+        uint32_t newPackets = packetCount - seenPackets;
+        seenPackets = packetCount;
+        if (state != LINK_STREAMING)
+        {
+            enter(LINK_STREAMING, now);
+            nextRegisterAt = now + RENEW_MS;
+        }
+        else
+            measureInterval(now, newPackets);
+    }
+    else
+    {
+        // The receive task can stamp a packet after the caller read now; that is no silence, not ~49 days of it
+        unsigned long silence = (long)(now - lastPacketMs) > 0 ? now - lastPacketMs : 0;
+        unsigned long interval = getIntervalMs();
+        unsigned long degradedAfter = interval * DEGRADED_INTERVALS > DEGRADED_MIN_MS ? interval * DEGRADED_INTERVALS : DEGRADED_MIN_MS;
+        unsigned long lostAfter = interval * LOST_INTERVALS > LOST_MIN_MS ? interval * LOST_INTERVALS : LOST_MIN_MS;
+        if (state == LINK_STREAMING && silence > degradedAfter)
+        {
+            enter(LINK_DEGRADED, now);
+            nextRegisterAt = now;
+            backoffMs = BACKOFF_FIRST_MS;
+        }
+        if (state == LINK_DEGRADED && silence > lostAfter)
+            enter(LINK_LOST, now);
+    }
+
+    if (!wifiUp || (long)(now - nextRegisterAt) < 0)
+        return false;
+    if (state == LINK_STREAMING)
+        nextRegisterAt = now + RENEW_MS;
+    else
+    {
+        nextRegisterAt = now + backoffMs;
+        backoffMs = backoffMs * 2 < BACKOFF_MAX_MS ? backoffMs * 2 : BACKOFF_MAX_MS;
+    }
+    return true;
+}
+
+void LinkMonitor::enter(LinkState next, unsigned long now)
+{
+    if (next == state)
+        return;
+    if (next == LINK_STREAMING)
+    {
+        if (outageStart)
+        {
+            lastRecoveryMs = now - outageStart;
+            recoveries++;
+        }
+        outageStart = 0;
+        if (state != LINK_DEGRADED)
+            connectedSince = now ? now : 1;
+        windowStart = now;
+        windowPackets = 0;
+    }
+    else if (state == LINK_STREAMING)
+        outageStart = now ? now : 1;
+    if (next == LINK_LOST || next == LINK_PROBING)
+        connectedSince = 0;
+    state = next;
+}
+
+void LinkMonitor::measureInterval(unsigned long now, uint32_t newPackets)
+{
+    windowPackets += newPackets;
+    unsigned long elapsed = now - windowStart;
+    if (elapsed < INTERVAL_WINDOW_MS)
+        return;
+    unsigned long sample = elapsed / windowPackets;
+    intervalMs = intervalMs ? (intervalMs * 7 + sample) / 8 : sample;
+    windowStart = now;
+    windowPackets = 0;
+}
+
+const char *LinkMonitor::stateName(LinkState state)
+{
+    switch (state)
+    {
+    case LINK_PROBING:
+        return "probing";
+    case LINK_STREAMING:
+        return "streaming";
+    case LINK_DEGRADED:
+        return "degraded";
+    case LINK_LOST:
+        return "lost";
+    }
+    return "?";
+}
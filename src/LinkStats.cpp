@@ -0,0 +1,61 @@
+#include "LinkStats.h"
+
+LinkStats::Verdict LinkStats::check(uint32_t frame, uint32_t nowUs)
+{
+    counters.received++;
+    recordInterval(nowUs);
+
+    int32_t delta = (int32_t)(frame - newestFrame);
+    if (haveFrame && delta == 0)
+    {
+        counters.duplicates++;
+        return DUPLICATE;
+    }
+    if (haveFrame && delta < 0 && (uint32_t)-delta <= RESYNC_FRAMES && ++staleRun < STALE_RUN_RESYNC)
+    {
+        counters.reordered++;
+        return STALE;
+    }
+    staleRun = 0;
+    if (!haveFrame || delta < 0 || (uint32_t)delta > RESYNC_FRAMES)
+    {
+        if (haveFrame)
+            counters.resyncs++;
+    }
+    else if (delta > 1)
+    {
+        counters.lost += delta - 1;
+        counters.gaps++;
+    }
+    haveFrame = true;
+    newestFrame = frame;
+    counters.accepted++;
+    return ACCEPT;
+}
+
+void LinkStats::recordInterval(uint32_t nowUs)
+{
+    if (counters.received == 1)
+    {
+        lastArrivalUs = nowUs;
+        return;
+    }
+    uint32_t interval = nowUs - lastArrivalUs;
+    lastArrivalUs = nowUs;
+
+    uint8_t bin = 0;
+    for (uint32_t limit = FIRST_BIN_US; interval >= limit && bin < LinkCounters::JITTER_BINS - 1; limit <<= 1)
+        bin++;
+    counters.intervalHistogram[bin]++;
+    if (interval > counters.maxIntervalUs)
+        counters.maxIntervalUs = interval;
+
+    // J += (|D| - J) / 16 with D the change in inter-arrival time
+    if (counters.received > 2)
+    {
+        uint32_t variation = interval > lastIntervalUs ? interval - lastIntervalUs : lastIntervalUs - interval;
+        jitterScaled += variation - ((jitterScaled + 8) >> 4);
+        counters.jitterUs = jitterScaled >> 4;
+    }
+    lastIntervalUs = interval;
+}
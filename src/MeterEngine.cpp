@@ -0,0 +1,91 @@
+#include "MeterEngine.h"
+
+MeterPeakCapture::MeterPeakCapture()
+{
+    for (uint8_t i = 0; i < METER_CHANNELS; i++)
+    {
+        peak[i] = NO_PEAK;
+        latest[i] = METER_FLOOR_DB100;
+    }
+}
+
+void MeterPeakCapture::capture(const int16_t *levelsDb100)
+{
+    for (uint8_t i = 0; i < METER_CHANNELS; i++)
+    {
+        int16_t level = levelsDb100[i];
+        latest[i].store(level, std::memory_order_relaxed);
+        int16_t current = peak[i].load(std::memory_order_relaxed);
+        while (level > current && !peak[i].compare_exchange_weak(current, level, std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+int16_t MeterPeakCapture::take(uint8_t channel)
+{
+    int16_t p = peak[channel].exchange(NO_PEAK, std::memory_order_relaxed);
+    return p == NO_PEAK ? latest[channel].load(std::memory_order_relaxed) : p;
+}
+
+MeterEngine::MeterEngine(const MeterBallistics &ballistics) : ballistics(ballistics)
+{
+}
+
+int32_t MeterEngine::approach(int32_t value, int32_t target, uint32_t dtMs, uint16_t tauMs)
+{
+    if (tauMs == 0)
+        return target;
+    int32_t k = (int32_t)((dtMs << 15) / (tauMs + dtMs)); // Q15
+    int32_t diff = target - value;
+    int32_t step = (diff * k) / 32768;
+    if (step == 0 && diff != 0)
+        step = diff > 0 ? 1 : -1; // always converge, even on tiny steps
+    return value + step;
+}
+
+int32_t MeterEngine::fall(int32_t value, int32_t floor, uint32_t dtMs, uint16_t db100PerSec)
+{
+    int32_t next = value - (int32_t)((db100PerSec * dtMs + 500) / 1000);
+    return next < floor ? floor : next;
+}
+
+void MeterEngine::update(MeterPeakCapture &source, unsigned long nowMs)
+{
+    uint32_t dt = lastUpdate == 0 ? 0 : nowMs - lastUpdate;
+    if (dt > 1000)
+        dt = 1000; // after a long pause just settle instead of overshooting
+    lastUpdate = nowMs;
+
+    bool anyMoving = false;
+    for (uint8_t i = 0; i < METER_CHANNELS; i++)
+    {
+        if (!((channelMask >> i) & 1))
+            continue; // no arc draws it, so audio there must not keep the display rendering
+        ChannelState &ch = levels[i];
+        int32_t target = source.take(i);
+        if (target < METER_FLOOR_DB100)
+            target = METER_FLOOR_DB100;
+
+        if (target > ch.level)
+            ch.level = approach(ch.level, target, dt, ballistics.attackMs);
+        else if (target < ch.level)
+            ch.level = ballistics.releaseDb100PerSec ? (int16_t)fall(ch.level, target, dt, ballistics.releaseDb100PerSec)
+                                                     : (int16_t)approach(ch.level, target, dt, ballistics.releaseMs);
+
+        // The marker shows the raw peak, not the smoothed level
+        if (target >= ch.peak)
+        {
+            ch.peak = target;
+            ch.peakTime = nowMs;
+        }
+        else if (nowMs - ch.peakTime > ballistics.peakHoldMs)
+        {
+            ch.peak = fall(ch.peak, ch.level, dt, ballistics.peakDecayDb100PerSec);
+        }
+
+        if (ch.level != target || ch.peak != ch.level)
+            anyMoving = true;
+    }
+    settled = !anyMoving;
+}
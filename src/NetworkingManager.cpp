@@ -1,8 +1,20 @@
 #include "NetworkingManager.h"
 
-NetworkingManager::NetworkingManager() : connected(false), lastPacketTime(0), lastRTPRequestTime(0), commandFrameCounter(0)
+NetworkingManager::NetworkingManager() : lastPacketTime(0), commandFrameCounter(0), gainAccumulator(GAIN_FLUSH_INTERVAL_MS), stripMap(&StripMap::defaults())
 {
     ipAddressNotSaved = false;
+    commandStatements = 0;
+    commandDatagrams = 0;
+    pendingStatements = 0;
+    textPacket.begin(++commandFrameCounter);
+    for (auto &gain : reportedStripGain)
+        gain = 0;
+    for (auto &state : notifiedStripState)
+        state = 0;
+    for (auto &gain : notifiedGain)
+        gain = INT16_MIN; // the first packet always wakes the display
+    for (auto &level : notifiedLevel)
+        level = LEVEL_FLOOR_DB100;
 }
 
 void NetworkingManager::setupStores()
@@ -21,11 +33,9 @@ bool NetworkingManager::begin()
     Serial.print("Destination IP set to: ");
     Serial.println(DEST_IP);
 
-    if (udp.listen(LOCAL_PORT))
+    if (udp.listen(LOCAL_PORT, onRTPacket, this))
     {
         Serial.println("UDP connected");
-        udp.onPacket([this](AsyncUDPPacket packet)
-                     { handleUDPPacket(packet); });
         return true;
     }
     else
@@ -37,48 +47,96 @@ bool NetworkingManager::begin()
 
 void NetworkingManager::update()
 {
-    if (millis() - lastRTPRequestTime > 10000 || lastRTPRequestTime == 0)
+    LinkState before = linkMonitor.getState();
+    unsigned long lastPacketMs = lastPacketTime; // before millis(), so a packet arriving in between is not in the future
+    if (linkMonitor.update(millis(), linkStats.getCounters().received, lastPacketMs, WiFi.status() == WL_CONNECTED))
+        sendRTPRegister();
+    if (linkMonitor.getState() != before)
+        Serial.printf("RT link %s -> %s\n", LinkMonitor::stateName(before), LinkMonitor::stateName(linkMonitor.getState()));
+    flushGainChanges(); // trailing edge of coalesced knob movement
+    if (ipAddressNotSaved && linkMonitor.getState() == LINK_STREAMING)
     {
-        // need to keep sending requests for more realtime data
-        std::vector<uint8_t> rtp_packet = createRTPPacket();
-        udp.writeTo(rtp_packet.data(), rtp_packet.size(), DEST_IP, LOCAL_PORT);
-        lastRTPRequestTime = millis();
+        // the new address answers: keep it (flash write, so not from the receive callback)
+        preferences.putChar("ipLastDigits", DEST_IP[3]);
+        ipAddressNotSaved = false;
     }
-    if (lastPacketTime == 0 || (millis() - lastPacketTime > 5000) || (WiFi.status() != WL_CONNECTED))
-    {
-        // haven't received data for a while, consider ourselves disconnected
-        connected = false;
-        connectionStartTime = 0;
-    }
-    else
+}
+
+void NetworkingManager::onRTPacket(void *context, const VBANPacketView &packet)
+{
+    static_cast<NetworkingManager *>(context)->handleRTPacket(packet);
+}
+
+// Runs on the tcpip thread with a view over the received pbuf; the socket has already checked it is an RT packet
+void NetworkingManager::handleRTPacket(const VBANPacketView &view)
+{
+    if (linkStats.check(view.frameNumber(), micros()) != LinkStats::ACCEPT)
     {
-        connected = true;
-        if (connectionStartTime == 0)
-            connectionStartTime = millis();
+        lastPacketTime = millis(); // the link is alive, the packet is just not newer than what we have
+        return;
     }
+
+    RTSnapshot *slot = rtPacketBuffer.beginWrite();
+    uint8_t changed = rtIngest.ingest(view, *slot, rtPacketBuffer.lastPublished());
+    if (changed & RT_CHANGED(RT_REGION_LEVELS))
+        meterPeaks.capture(slot->packet.inputLeveldB100);
+    bool wakeDisplay = visibleFieldsChanged(slot->packet, changed);
+    rtPacketBuffer.publish();
+    if (wakeDisplay && visibleChangeCallback)
+        visibleChangeCallback();
+    if (changed & RT_CHANGED(RT_REGION_GAINS))
+        for (uint8_t i = 0; i < GainAccumulator::NUM_STRIPS; i++)
+            reportedStripGain[i].store(view.stripGain(i), std::memory_order_relaxed);
+    lastPacketTime = millis();
 }
 
-void NetworkingManager::handleUDPPacket(AsyncUDPPacket packet)
+bool NetworkingManager::visibleFieldsChanged(const tagVBAN_VMRT_PACKET &packet, uint8_t changedRegions)
 {
-    if (packet.length() < sizeof(tagVBAN_HEADER))
-        return;
-    tagVBAN_HEADER *header = (tagVBAN_HEADER *)packet.data();
-    if (header->vban != 0x4E414256)
-        return; // not VBAN
-    unsigned char protocol = header->format_SR & VBAN_PROTOCOL_MASK;
-    if (protocol == VBAN_PROTOCOL_SERVICE && header->format_nbc == VBAN_SERVICE_RTPACKET)
+    bool changed = false;
+
+    // Routing buttons: the Output Matrix pages over every strip, so all of them count
+    if (changedRegions & RT_CHANGED(RT_REGION_STATE))
+    {
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            if (packet.stripState[i] != notifiedStripState[i])
+            {
+                notifiedStripState[i] = packet.stripState[i];
+                changed = true;
+            }
+        }
+    }
+
+    // Gains and meters: only the strips and level channels on the Monitor rings
+    for (uint8_t slot = 0; slot < STRIP_MAP_SLOTS; slot++)
     {
-        if (packet.length() >= sizeof(tagVBAN_VMRT_PACKET))
+        if (changedRegions & RT_CHANGED(RT_REGION_GAINS))
         {
-            memcpy(&currentRTPPacket, packet.data(), sizeof(tagVBAN_VMRT_PACKET));
-            lastPacketTime = millis();
-            if (ipAddressNotSaved)
+            int16_t gain = vmrtStripGain(packet, stripMap->strip[slot]);
+            if (gain != notifiedGain[slot])
             {
-                preferences.putChar("ipLastDigits", DEST_IP[3]);
-                ipAddressNotSaved = false;
+                notifiedGain[slot] = gain;
+                changed = true;
+            }
+        }
+        if (!(changedRegions & RT_CHANGED(RT_REGION_LEVELS)))
+            continue;
+        const uint8_t channels[2] = {stripMap->levelLeft[slot], stripMap->levelRight[slot]};
+        for (uint8_t side = 0; side < 2; side++)
+        {
+            // Meters: anything under -60 dB draws as empty, and tiny movements are not visible
+            int16_t level = packet.inputLeveldB100[channels[side]];
+            if (level < LEVEL_FLOOR_DB100)
+                level = LEVEL_FLOOR_DB100;
+            int16_t &notified = notifiedLevel[slot * 2 + side];
+            if (abs(level - notified) >= LEVEL_CHANGE_THRESHOLD_DB100)
+            {
+                notified = level;
+                changed = true;
             }
         }
     }
+    return changed;
 }
 
 void NetworkingManager::sendCommand(const NetworkCommand &command)
@@ -87,26 +145,24 @@ void NetworkingManager::sendCommand(const NetworkCommand &command)
     {
     case NetworkCommandType::SEND_VBAN_COMMAND:
     {
-        std::vector<uint8_t> commandPacket = createCommandPacket(command.payload);
-        udp.writeTo(commandPacket.data(), commandPacket.size(), DEST_IP, LOCAL_PORT);
-        Serial.println("sent packet");
-
+        sendVBANCommand(command.payload);
         break;
     }
     case NetworkCommandType::SET_IP:
     {
         Serial.print("Setting new IP ending to: ");
         Serial.println(command.payload);
-        byte lastDigits = atoi(&command.payload[strlen(command.payload) - 3]);
-        String firstDigitsOfCurrentIP = String(WiFi.localIP()[0]) + "." + String(WiFi.localIP()[1]) + "." + String(WiFi.localIP()[2]) + ".";
-        String newIPString = firstDigitsOfCurrentIP + String(lastDigits);
-        auto newIP = IPAddress();
-        newIP.fromString(newIPString);
-        DEST_IP = newIP;
+        flushCommands(); // what is already batched was meant for the old address
+        const char *digits = command.payload;
+        size_t digitCount = strlen(digits);
+        if (digitCount > 3)
+            digits += digitCount - 3;
+        byte lastDigits = atoi(digits);
+        IPAddress localIP = WiFi.localIP();
+        DEST_IP = IPAddress(localIP[0], localIP[1], localIP[2], lastDigits);
 
         ipAddressNotSaved = true; // only save when we get a response back
-        std::vector<uint8_t> rtp_packet = createRTPPacket();
-        udp.writeTo(rtp_packet.data(), rtp_packet.size(), DEST_IP, LOCAL_PORT);
+        sendRTPRegister();
         break;
     }
     default:
@@ -114,48 +170,66 @@ void NetworkingManager::sendCommand(const NetworkCommand &command)
     }
 }
 
-void NetworkingManager::sendVBANCommand(const String &command)
+void NetworkingManager::sendVBANCommand(const char *command)
+{
+    // Appended to the open datagram, which flushCommands() sends; no String, no vector, no heap
+    if (!textPacket.append(command))
+    {
+        flushCommands();
+        if (!textPacket.append(command))
+        {
+            Serial.println("VBAN command too long, dropped");
+            return;
+        }
+    }
+    // A command may already hold several ';'-separated statements
+    pendingStatements++;
+    for (const char *c = command; *c; c++)
+        pendingStatements += *c == ';';
+}
+
+void NetworkingManager::flushCommands()
 {
-    NetworkCommand item;
-    item.type = NetworkCommandType::SEND_VBAN_COMMAND;
-    strncpy(item.payload, command.c_str(), sizeof(item.payload));
-    item.payload[sizeof(item.payload) - 1] = '\0';
-    sendCommand(item);
+    if (textPacket.empty())
+        return;
+    // Only what actually left counts towards the "net" totals
+    if (udp.writeTo(textPacket.data(), textPacket.size(), DEST_IP, LOCAL_PORT) == textPacket.size())
+    {
+        commandDatagrams++;
+        commandStatements += pendingStatements;
+    }
+    pendingStatements = 0;
+    textPacket.begin(++commandFrameCounter);
 }
 
 void NetworkingManager::incrementVolume(uint8_t channel, bool up)
 {
-    String command = "strip(" + String(channel + 5) + ").gain " + (up ? "+" : "-") + "= 3";
-    sendVBANCommand(command);
+    VBANCommandString<32> command;
+    command.stripGainStep(stripMap->strip[channel], up, 3);
+    sendVBANCommand(command.c_str());
 }
-void NetworkingManager::incrementVolume(uint8_t channel, float level)
+int16_t NetworkingManager::incrementVolume(uint8_t channel, float level)
 {
-    String command = "strip(" + String(channel + 5) + ").gain " + "+= " + String(level, 2);
-    sendVBANCommand(command);
+    // Merged with other knob movement; at most one Strip[n].Gain per flush interval goes out
+    uint8_t strip = stripMap->strip[channel];
+    gainAccumulator.add(strip, level, reportedStripGain[strip].load(std::memory_order_relaxed), millis());
+    flushGainChanges();
+    return gainAccumulator.getTarget(strip);
 }
 
-std::vector<uint8_t> NetworkingManager::createCommandPacket(const String &command)
+void NetworkingManager::flushGainChanges()
 {
-    String streamName = "Command1";
-    commandFrameCounter++;
-    std::vector<uint8_t> packet = {0x56, 0x42, 0x41, 0x4e, 0x40, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, commandFrameCounter, 0x00, 0x00, 0x00};
-    for (int i = 0; i < 16; i++)
+    VBANCommandString<32> command;
+    while (gainAccumulator.popCommand(millis(), command))
     {
-        packet[i + 8] = streamName[i];
+        sendVBANCommand(command.c_str());
+        command.clear();
     }
-    packet.insert(packet.end(), command.begin(), command.end());
-
-    // Serial.print("Mute packet: ");
-    // printVector(mute_packet);
-    // Serial.print("Size of mute_packet: ");
-    // Serial.println(sizeof(mute_packet));
-    return packet;
 }
 
-std::vector<uint8_t> NetworkingManager::createRTPPacket()
+void NetworkingManager::sendRTPRegister()
 {
-    std::vector<uint8_t> rtp_packet = {0x56, 0x42, 0x41, 0x4e, 0x60, 0x00, 0x20, 0x0f, 0x52, 0x65, 0x67, 0x69, 0x73, 0x74, 0x65, 0x72, 0x20, 0x52, 0x54, 0x50, 0x01, 0x59, 0x41, 0, 0, 0, 0, 154};
-    return rtp_packet;
+    udp.writeTo(VBAN_RT_REGISTER_PACKET, sizeof(VBAN_RT_REGISTER_PACKET), DEST_IP, LOCAL_PORT);
 }
 
 char NetworkingManager::getDestIP()
@@ -0,0 +1,97 @@
+#include "PredictedState.h"
+
+static const int16_t GAIN_TOLERANCE_DB100 = 1; // Voicemeeter may round to the nearest 0.01 dB
+
+void PredictedState::predictGain(uint8_t strip, int16_t gainDb100, uint32_t currentFrame, unsigned long now)
+{
+    if (strip >= NUM_STRIPS)
+        return;
+    PendingGain &p = gains[strip];
+    p.active = true;
+    p.value = gainDb100;
+    p.issuedFrame = currentFrame;
+    p.issuedTime = now;
+}
+
+void PredictedState::predictRouting(uint8_t strip, uint32_t stateMask, bool enabled, uint32_t currentFrame, unsigned long now)
+{
+    if (strip >= NUM_STRIPS)
+        return;
+    PendingRouting &p = routing[strip];
+    p.mask |= stateMask;
+    p.value = enabled ? (p.value | stateMask) : (p.value & ~stateMask);
+    p.issuedFrame = currentFrame;
+    p.issuedTime = now;
+    routingRevision++;
+}
+
+bool PredictedState::expired(uint32_t issuedFrame, unsigned long issuedTime, uint32_t frame, unsigned long now)
+{
+    return (int32_t)(frame - issuedFrame) > (int32_t)GRACE_FRAMES || now - issuedTime > TIMEOUT_MS;
+}
+
+void PredictedState::reconcile(const tagVBAN_VMRT_PACKET &packet, unsigned long now)
+{
+    const uint32_t frame = packet.frameCounter;
+    for (uint8_t i = 0; i < NUM_STRIPS; i++)
+    {
+        PendingGain &g = gains[i];
+        if (g.active)
+        {
+            int16_t reported = vmrtStripGain(packet, i);
+            bool newer = (int32_t)(frame - g.issuedFrame) > 0;
+            int diff = reported - g.value;
+            if (newer && diff <= GAIN_TOLERANCE_DB100 && diff >= -GAIN_TOLERANCE_DB100)
+                g.active = false; // confirmed
+            else if (expired(g.issuedFrame, g.issuedTime, frame, now))
+            {
+                g.active = false; // contradicted or lost: show what Voicemeeter has
+                rollbacks++;
+            }
+        }
+
+        PendingRouting &r = routing[i];
+        if (r.mask)
+        {
+            bool newer = (int32_t)(frame - r.issuedFrame) > 0;
+            uint32_t matching = ~(packet.stripState[i] ^ r.value) & r.mask;
+            if (newer)
+                r.mask &= ~matching; // confirmed bits
+            if (r.mask && expired(r.issuedFrame, r.issuedTime, frame, now))
+            {
+                r.mask = 0;
+                rollbacks++;
+                routingRevision++;
+            }
+        }
+    }
+}
+
+int16_t PredictedState::stripGain(const tagVBAN_VMRT_PACKET &packet, uint8_t strip) const
+{
+    if (strip >= NUM_STRIPS)
+        return 0;
+    if (gains[strip].active)
+        return gains[strip].value;
+    return vmrtStripGain(packet, strip);
+}
+
+uint32_t PredictedState::stripState(const tagVBAN_VMRT_PACKET &packet, uint8_t strip) const
+{
+    if (strip >= NUM_STRIPS)
+        return 0;
+    const PendingRouting &r = routing[strip];
+    return (packet.stripState[strip] & ~r.mask) | (r.value & r.mask);
+}
+
+uint8_t PredictedState::inFlightCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < NUM_STRIPS; i++)
+    {
+        count += gains[i].active;
+        for (uint32_t bits = routing[i].mask; bits; bits &= bits - 1)
+            count++;
+    }
+    return count;
+}
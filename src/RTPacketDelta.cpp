@@ -0,0 +1,59 @@
+#include "RTPacketDelta.h"
+#include <string.h>
+
+static const size_t regionOffsets[RT_REGION_COUNT + 1] = {
+    0,
+    offsetof(tagVBAN_VMRT_PACKET, inputLeveldB100),
+    offsetof(tagVBAN_VMRT_PACKET, TransportBit),
+    offsetof(tagVBAN_VMRT_PACKET, stripGaindB100Layer1),
+    offsetof(tagVBAN_VMRT_PACKET, stripLabelUTF8c60),
+    sizeof(tagVBAN_VMRT_PACKET)};
+
+static_assert(offsetof(tagVBAN_VMRT_PACKET, inputLeveldB100) % 4 == 0 && offsetof(tagVBAN_VMRT_PACKET, TransportBit) % 4 == 0 &&
+                  offsetof(tagVBAN_VMRT_PACKET, stripGaindB100Layer1) % 4 == 0 && offsetof(tagVBAN_VMRT_PACKET, stripLabelUTF8c60) % 4 == 0 &&
+                  sizeof(tagVBAN_VMRT_PACKET) % 4 == 0,
+              "RT regions must be whole words");
+
+size_t RTPacketIngest::regionOffset(uint8_t region)
+{
+    return regionOffsets[region];
+}
+
+// The UDP payload may be unaligned, so its words are loaded through memcpy; the snapshot is aligned
+static bool wordsEqual(const uint8_t *incoming, const uint8_t *snapshot, size_t bytes)
+{
+    const uint32_t *words = reinterpret_cast<const uint32_t *>(snapshot);
+    for (size_t i = 0; i < bytes / 4; i++)
+    {
+        uint32_t word;
+        memcpy(&word, incoming + i * 4, 4);
+        if (word != words[i])
+            return false;
+    }
+    return true;
+}
+
+uint8_t RTPacketIngest::ingest(const VBANPacketView &view, RTSnapshot &slot, const RTSnapshot *latest)
+{
+    sequence++;
+    uint8_t changed = 0;
+    uint8_t *destination = reinterpret_cast<uint8_t *>(&slot.packet);
+    const uint8_t *reference = latest ? reinterpret_cast<const uint8_t *>(&latest->packet) : nullptr;
+    for (uint8_t r = 0; r < RT_REGION_COUNT; r++)
+    {
+        size_t offset = regionOffsets[r];
+        size_t size = regionOffsets[r + 1] - offset;
+        if (r == RT_REGION_HEADER || !reference || !wordsEqual(view.raw() + offset, reference + offset, size))
+        {
+            stamps[r] = sequence;
+            changed |= RT_CHANGED(r);
+        }
+        // A slot stamped with the current version already holds exactly these bytes
+        if (slot.regionStamp[r] != stamps[r])
+        {
+            memcpy(destination + offset, view.raw() + offset, size);
+            slot.regionStamp[r] = stamps[r];
+        }
+    }
+    return changed;
+}
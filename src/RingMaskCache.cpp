@@ -0,0 +1,254 @@
+#include "RingMaskCache.h"
+#include <math.h>
+#include <stdlib.h>
+#include "ArcSectorUpdater.h"
+
+// The direct fill reads layer internals (_clip_area, draw_buf) as LVGL 9.4 lays them out, and relies on
+// draw tasks being dispatched synchronously; anything else falls back to lv_draw_arc
+#if LVGL_VERSION_MAJOR == 9 && LVGL_VERSION_MINOR == 4 && LV_USE_OS == LV_OS_NONE && LV_DRAW_SW_DRAW_UNIT_CNT == 1
+#define RING_MASK_DIRECT_FILL 1
+#else
+#define RING_MASK_DIRECT_FILL 0
+#endif
+
+RingMask RingMaskCache::rings[MAX_RINGS];
+uint8_t RingMaskCache::ringCount = 0;
+RingMaskCache::AttachedArc RingMaskCache::arcs[MAX_ARCS];
+uint8_t RingMaskCache::arcCount = 0;
+uint32_t RingMaskCache::cachedSweeps = 0;
+
+static int32_t normalizeAngle(int32_t angle)
+{
+    angle %= 360;
+    return angle < 0 ? angle + 360 : angle;
+}
+
+static float clamp01(float v)
+{
+    return v < 0 ? 0 : (v > 1 ? 1 : v);
+}
+
+// Pixel centre distance against both edges, each with a one pixel ramp
+static uint8_t ringCoverage(int32_t dx, int32_t dy, float outer, float inner)
+{
+    float d = sqrtf((float)(dx * dx + dy * dy));
+    float a = clamp01(outer + 0.5f - d);
+    float b = inner > 0 ? clamp01(d - inner + 0.5f) : 1.0f;
+    return (uint8_t)(a * b * 255.0f + 0.5f);
+}
+
+// Coverage ramp across a half-plane edge; cross is the signed distance in px << 15
+static inline int32_t edgeFactor(int32_t cross)
+{
+    int32_t s = (cross >> 11) + 8; // 1/16 px, centred on the edge
+    return s < 0 ? 0 : (s > 16 ? 16 : s);
+}
+
+static inline uint16_t blend565(uint16_t fg, uint16_t bg, uint32_t alpha)
+{
+    uint32_t a = (alpha + 4) >> 3;
+    uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81F;
+    uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81F;
+    uint32_t r = ((((f - b) * a) >> 5) + b) & 0x07E0F81F;
+    return (uint16_t)(r | (r >> 16));
+}
+
+const RingMask *RingMaskCache::findOrBuild(int32_t radius, int32_t width)
+{
+    for (uint8_t i = 0; i < ringCount; i++)
+        if (rings[i].radius == radius && rings[i].width == width)
+            return &rings[i];
+    if (ringCount >= MAX_RINGS || radius <= 0 || radius > 254 || width <= 0)
+        return nullptr;
+
+    RingMask &ring = rings[ringCount];
+    ring.radius = radius;
+    ring.width = width;
+    ring.rowOffset = (uint16_t *)malloc((radius + 1) * sizeof(uint16_t));
+    ring.rowFirst = (uint8_t *)malloc(radius + 1);
+    ring.rowLength = (uint8_t *)malloc(radius + 1);
+    ring.coverage = nullptr;
+    float outer = radius;
+    float inner = radius - width;
+
+    uint32_t total = 0;
+    if (ring.rowOffset && ring.rowFirst && ring.rowLength)
+    {
+        for (int32_t dy = 0; dy <= radius; dy++)
+        {
+            int32_t first = -1, last = -1;
+            for (int32_t dx = 0; dx <= radius; dx++)
+            {
+                if (ringCoverage(dx, dy, outer, inner))
+                {
+                    if (first < 0)
+                        first = dx;
+                    last = dx;
+                }
+            }
+            ring.rowOffset[dy] = total;
+            ring.rowFirst[dy] = first < 0 ? 0 : first;
+            ring.rowLength[dy] = first < 0 ? 0 : last - first + 1; // one run per quadrant row: the hole only trims small |dx|
+            total += ring.rowLength[dy];
+        }
+        ring.coverage = (uint8_t *)malloc(total);
+    }
+    if (!ring.coverage)
+    {
+        free(ring.rowOffset);
+        free(ring.rowFirst);
+        free(ring.rowLength);
+        return nullptr;
+    }
+
+    for (int32_t dy = 0; dy <= radius; dy++)
+        for (int32_t i = 0; i < ring.rowLength[dy]; i++)
+            ring.coverage[ring.rowOffset[dy] + i] = ringCoverage(ring.rowFirst[dy] + i, dy, outer, inner);
+
+    ringCount++;
+    return &ring;
+}
+
+bool RingMaskCache::attach(lv_obj_t *arc)
+{
+    if (arcCount >= MAX_ARCS)
+        return false;
+    lv_obj_update_layout(arc);
+
+    lv_point_t center;
+    int32_t radius;
+    ArcSectorUpdater::arcCenter(arc, center, radius);
+    int32_t mainWidth = lv_obj_get_style_arc_width(arc, LV_PART_MAIN);
+    int32_t indicatorWidth = lv_obj_get_style_arc_width(arc, LV_PART_INDICATOR);
+    // The cache only knows flat ends
+    if ((mainWidth > 0 && lv_obj_get_style_arc_rounded(arc, LV_PART_MAIN)) ||
+        (indicatorWidth > 0 && lv_obj_get_style_arc_rounded(arc, LV_PART_INDICATOR)))
+        return false;
+
+    AttachedArc &a = arcs[arcCount];
+    a.main = mainWidth > 0 ? findOrBuild(radius, mainWidth) : nullptr;
+    a.indicator = indicatorWidth > 0 ? findOrBuild(radius - ArcSectorUpdater::indicatorInset(arc), indicatorWidth) : nullptr;
+    if ((mainWidth > 0 && !a.main) || (indicatorWidth > 0 && !a.indicator))
+        return false;
+    a.mainOpa = lv_obj_get_style_arc_opa(arc, LV_PART_MAIN);
+    a.indicatorOpa = lv_obj_get_style_arc_opa(arc, LV_PART_INDICATOR);
+
+    lv_obj_set_style_arc_opa(arc, LV_OPA_TRANSP, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_arc_opa(arc, LV_OPA_TRANSP, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(arc, drawEvent, LV_EVENT_DRAW_MAIN, &a);
+    arcCount++;
+    return true;
+}
+
+void RingMaskCache::reset()
+{
+    for (uint8_t i = 0; i < ringCount; i++)
+    {
+        free(rings[i].rowOffset);
+        free(rings[i].rowFirst);
+        free(rings[i].rowLength);
+        free(rings[i].coverage);
+    }
+    ringCount = 0;
+    arcCount = 0;
+}
+
+void RingMaskCache::drawEvent(lv_event_t *e)
+{
+    lv_obj_t *arc = (lv_obj_t *)lv_event_get_current_target(e);
+    const AttachedArc *a = (const AttachedArc *)lv_event_get_user_data(e);
+    lv_layer_t *layer = lv_event_get_layer(e);
+
+    lv_point_t center;
+    int32_t radius;
+    ArcSectorUpdater::arcCenter(arc, center, radius);
+    int32_t rotation = lv_arc_get_rotation(arc);
+    if (a->main)
+        drawSweep(layer, *a->main, center, (int32_t)lv_arc_get_bg_angle_start(arc) + rotation, (int32_t)lv_arc_get_bg_angle_end(arc) + rotation,
+                  lv_obj_get_style_arc_color(arc, LV_PART_MAIN), a->mainOpa);
+    if (a->indicator)
+        drawSweep(layer, *a->indicator, center, (int32_t)lv_arc_get_angle_start(arc) + rotation, (int32_t)lv_arc_get_angle_end(arc) + rotation,
+                  lv_obj_get_style_arc_color(arc, LV_PART_INDICATOR), a->indicatorOpa);
+}
+
+void RingMaskCache::drawSweep(lv_layer_t *layer, const RingMask &ring, lv_point_t center, int32_t startAngle, int32_t endAngle,
+                              lv_color_t color, lv_opa_t opa)
+{
+    if (opa <= LV_OPA_MIN || startAngle == endAngle)
+        return;
+#if RING_MASK_DIRECT_FILL
+    if (layer->draw_buf && layer->color_format == LV_COLOR_FORMAT_RGB565)
+    {
+        fillSweep(layer, ring, center, startAngle, endAngle, color, opa);
+        cachedSweeps++;
+        return;
+    }
+#endif
+    lv_draw_arc_dsc_t dsc;
+    lv_draw_arc_dsc_init(&dsc);
+    dsc.center = center;
+    dsc.radius = ring.radius;
+    dsc.width = ring.width;
+    dsc.start_angle = startAngle;
+    dsc.end_angle = endAngle;
+    dsc.color = color;
+    dsc.opa = opa;
+    dsc.rounded = 0;
+    lv_draw_arc(layer, &dsc);
+}
+
+void RingMaskCache::fillSweep(lv_layer_t *layer, const RingMask &ring, lv_point_t center, int32_t startAngle, int32_t endAngle,
+                              lv_color_t color, lv_opa_t opa)
+{
+    lv_area_t box = {center.x - ring.radius, center.y - ring.radius, center.x + ring.radius, center.y + ring.radius};
+    lv_area_t area;
+    if (!lv_area_intersect(&area, &box, &layer->_clip_area))
+        return;
+
+    // Wedge = intersection (up to 180 degrees) or union (beyond) of the half-planes after start and before end
+    int32_t sweep = normalizeAngle(endAngle - startAngle);
+    bool fullRing = sweep == 0;
+    bool wide = sweep > 180;
+    int32_t s0x = lv_trigo_cos(normalizeAngle(startAngle)), s0y = lv_trigo_sin(normalizeAngle(startAngle));
+    int32_t e1x = lv_trigo_cos(normalizeAngle(endAngle)), e1y = lv_trigo_sin(normalizeAngle(endAngle));
+
+    uint16_t fg = lv_color_to_u16(color);
+    lv_draw_buf_t *buf = layer->draw_buf;
+    uint32_t stride = buf->header.stride;
+
+    for (int32_t y = area.y1; y <= area.y2; y++)
+    {
+        int32_t dy = y - center.y;
+        int32_t ady = dy < 0 ? -dy : dy;
+        uint8_t length = ring.rowLength[ady];
+        if (!length)
+            continue;
+        int32_t first = ring.rowFirst[ady];
+        int32_t last = first + length - 1;
+        const uint8_t *cov = ring.coverage + ring.rowOffset[ady];
+        uint16_t *row = (uint16_t *)(buf->data + (y - layer->buf_area.y1) * stride);
+
+        auto plot = [&](int32_t x, int32_t dx, uint8_t c)
+        {
+            uint32_t alpha = (c * (opa + 1)) >> 8;
+            if (!fullRing)
+            {
+                int32_t after = edgeFactor(s0x * dy - s0y * dx);
+                int32_t before = edgeFactor(dx * e1y - dy * e1x);
+                int32_t f = wide ? LV_MAX(after, before) : LV_MIN(after, before);
+                alpha = (alpha * f) >> 4;
+            }
+            if (alpha)
+            {
+                uint16_t &px = row[x - layer->buf_area.x1];
+                px = alpha >= 255 ? fg : blend565(fg, px, alpha);
+            }
+        };
+
+        // Right half including the centre column, then the mirrored left half
+        for (int32_t adx = LV_MAX(first, area.x1 - center.x); adx <= LV_MIN(last, area.x2 - center.x); adx++)
+            plot(center.x + adx, adx, cov[adx - first]);
+        for (int32_t adx = LV_MAX(LV_MAX(first, 1), center.x - area.x2); adx <= LV_MIN(last, center.x - area.x1); adx++)
+            plot(center.x - adx, -adx, cov[adx - first]);
+    }
+}
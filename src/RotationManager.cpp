@@ -4,11 +4,16 @@ static RotationManager *g_rotation_instance = nullptr;
 
 void IRAM_ATTR RotationManager::dataReadyISR()
 {
-    if (g_rotation_instance)
-        g_rotation_instance->dataReady = true;
+    // Wake the sensor task straight away instead of waiting for the next loop() tick
+    if (g_rotation_instance && g_rotation_instance->sensorTaskHandle)
+    {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(g_rotation_instance->sensorTaskHandle, &higherPriorityTaskWoken);
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    }
 }
 
-RotationManager::RotationManager() : mlx(), arduinoHal(), lastAngle(-100.0f), lastRotationTime(0), dataReady(false)
+RotationManager::RotationManager() : mlx(), arduinoHal(), lastAngle(0), lastRotationTime(0)
 {
     arduinoHal.set_twoWire(&Wire1);
 }
@@ -16,7 +21,6 @@ RotationManager::RotationManager() : mlx(), arduinoHal(), lastAngle(-100.0f), la
 void RotationManager::begin()
 {
     g_rotation_instance = this;
-    attachInterrupt(digitalPinToInterrupt(INT_PIN), RotationManager::dataReadyISR, RISING);
 
     uint8_t status = mlx.begin_with_hal(&arduinoHal); // A1, A0
     mlx.reset();
@@ -26,57 +30,87 @@ void RotationManager::begin()
     mlx.setOverSampling(2);
     mlx.setDigitalFiltering(4);
     mlx.setBurstDataRate(0); // this number gets multiplied by 20ms to set the burst data rate
+
+    // The task must exist before the first interrupt can notify it
+    busMutex = xSemaphoreCreateMutex();
+    xTaskCreatePinnedToCore(sensorTask, "RotationTask", 3072, this, SENSOR_TASK_PRIORITY, &sensorTaskHandle, SENSOR_TASK_CORE);
+    sampling = true;
+    attachInterrupt(digitalPinToInterrupt(INT_PIN), RotationManager::dataReadyISR, RISING);
     mlx.startBurst(MLX90393::X_FLAG | MLX90393::Y_FLAG);
 
     initialized = true; // Mark as initialized after setup complete
 }
 
-float RotationManager::update()
+void RotationManager::sensorTask(void *pv)
 {
-    // Read magnetometer data if ready
-    if (dataReady)
+    RotationManager *mgr = static_cast<RotationManager *>(pv);
+    for (;;)
     {
-        dataReady = false;
-        MLX90393::txyzRaw data; // Structure to hold x, y, z data
+        // Sleeps until dataReadyISR; several pending notifications collapse into one read
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xSemaphoreTake(mgr->busMutex, portMAX_DELAY);
+        if (mgr->sampling)
+            mgr->readSample();
+        xSemaphoreGive(mgr->busMutex);
+    }
+}
+
+void RotationManager::readSample()
+{
+    MLX90393::txyzRaw data; // Structure to hold x, y, z data
+
+    // Read the magnetometer data (this should be fast in burst mode)
+    if (!mlx.readMeasurement(MLX90393::X_FLAG | MLX90393::Y_FLAG, data))
+        return;
+
+    int16_t x = static_cast<int16_t>(data.x);
+    int16_t y = static_cast<int16_t>(data.y);
+    // Integer atan2 keeps core 0 cheap at the maximum burst rate; only differences are used, so no 0-360 offset
+    RotationSample sample = {static_cast<uint32_t>(micros()), fixedAtan2(-static_cast<int32_t>(y), x)};
+    if (!samples.push(sample))
+        droppedSamples.fetch_add(1, std::memory_order_relaxed); // control loop stalled; newest sample is lost
+}
 
-        // Read the magnetometer data (this should be fast in burst mode)
-        if (mlx.readMeasurement(MLX90393::X_FLAG | MLX90393::Y_FLAG, data))
+float RotationManager::update()
+{
+    RotationSample sample;
+    while (samples.pop(sample))
+    {
+        if (numStartupSamples <= 4) // discard first few samples to allow settling
         {
-            int16_t x = static_cast<int16_t>(data.x);
-            int16_t y = static_cast<int16_t>(data.y);
-            float angle = atan2(-y, x);
-            angle = angle * 180 / PI; // convert to degrees
-            angle += 180;             // offset to 0-360 degrees
-
-            if (numStartupSamples <= 4) // discard first few samples to allow settling
-            {
-                lastAngle = angle;
-                numStartupSamples++;
-                return 0.0f;
-            }
-
-            // Serial.printf("X: %d, Y: %d, Angle: %.2f\n", x, y, angle);
-
-            float angleDiff = angle - lastAngle;
-            if (angleDiff > 180)
-                angleDiff -= 360;
-            if (angleDiff < -180)
-                angleDiff += 360;
-
-            if (abs(angleDiff) > ANGLE_DEADBAND)
-            {
-                lastAngle = angle;
-                lastRotationTime = millis();
-
-                return angleDiff;
-            }
+            lastAngle = sample.angle;
+            numStartupSamples++;
+            continue;
         }
+
+        // Serial.printf("%lu,%d\n", sample.timestampUs, sample.angle); // trace format read by tools/knob_trace
+
+        int16_t angleDiff = angleQ15Delta(lastAngle, sample.angle); // wraps across 0/360 by itself
+        lastAngle = sample.angle;
+        knobFilter.addSample(sample.timestampUs, angleQ15ToDegrees(angleDiff));
     }
-    return 0.0f;
+
+    float dbChange = knobFilter.takeDb();
+    if (dbChange != 0.0f)
+        lastRotationTime = millis();
+    return dbChange;
+}
+
+void RotationManager::stopSampling()
+{
+    // Keep the sensor task off the bus while the loop reconfigures the magnetometer
+    sampling = false;
+    detachInterrupt(digitalPinToInterrupt(INT_PIN));
+    if (!busMutex)
+        return; // never begun, no task
+    // Once we hold the mutex any read in progress has finished, and every later wake-up sees sampling cleared
+    xSemaphoreTake(busMutex, portMAX_DELAY);
+    xSemaphoreGive(busMutex);
 }
 
 void RotationManager::enterWakeOnChangeMode()
 {
+    stopSampling();
     mlx.exit();
     uint8_t wocDiff;
     mlx.getWocDiff(wocDiff);
@@ -93,6 +127,7 @@ void RotationManager::enterWakeOnChangeMode()
 
 void RotationManager::deepSleep()
 {
+    stopSampling();
     mlx.setBurstDataRate(64); // this number gets multiplied by 20ms to set the burst data rate
     mlx.exit();
     delay(10);
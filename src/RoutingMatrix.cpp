@@ -0,0 +1,69 @@
+#include "RoutingMatrix.h"
+#include "VoicemeeterProtocol.h"
+
+RoutingMatrix::RoutingMatrix(uint8_t firstStrip)
+    : stripOffset(clampOffset(firstStrip, NUM_STRIPS, POOL_COLUMNS))
+{
+}
+
+uint8_t RoutingMatrix::clampOffset(int offset, uint8_t count, uint8_t window)
+{
+    if (offset < 0)
+        return 0;
+    return offset > count - window ? count - window : offset;
+}
+
+// Pages start every `window` entries, the last one is pulled back to end at `count`
+uint8_t RoutingMatrix::pageOf(uint8_t offset, uint8_t window)
+{
+    return (offset + window - 1) / window;
+}
+
+bool RoutingMatrix::scrollStrips(int8_t pages)
+{
+    int page = pageOf(stripOffset, POOL_COLUMNS) + pages;
+    uint8_t offset = clampOffset(page * POOL_COLUMNS, NUM_STRIPS, POOL_COLUMNS);
+    if (offset == stripOffset)
+        return false;
+    stripOffset = offset;
+    shownValid = false;
+    return true;
+}
+
+bool RoutingMatrix::scrollBuses(int8_t pages)
+{
+    const int pageCount = pageOf(NUM_BUSES, POOL_ROWS);
+    int page = ((pageOf(busOffset, POOL_ROWS) + pages) % pageCount + pageCount) % pageCount;
+    uint8_t offset = clampOffset(page * POOL_ROWS, NUM_BUSES, POOL_ROWS);
+    if (offset == busOffset)
+        return false;
+    busOffset = offset;
+    shownValid = false;
+    return true;
+}
+
+uint16_t RoutingMatrix::applyRouting(const uint8_t routing[NUM_STRIPS])
+{
+    uint16_t window = 0;
+    for (uint8_t c = 0; c < POOL_COLUMNS; c++)
+        window |= ((routing[stripOffset + c] >> busOffset) & ((1 << POOL_ROWS) - 1)) << (c * POOL_ROWS);
+
+    uint16_t changed = shownValid ? window ^ shown : (1 << POOL_SIZE) - 1;
+    shown = window;
+    shownValid = true;
+    return changed;
+}
+
+uint8_t RoutingMatrix::routingBits(uint32_t stripState)
+{
+    // A1..A4 are contiguous, B1..B3 follow them and A5 was added above B3
+    return ((stripState & (VMRTSTATE_MODE_BUSA1 | VMRTSTATE_MODE_BUSA2 | VMRTSTATE_MODE_BUSA3 | VMRTSTATE_MODE_BUSA4)) >> 12) |
+           ((stripState & VMRTSTATE_MODE_BUSA5) >> 15) |
+           ((stripState & (VMRTSTATE_MODE_BUSB1 | VMRTSTATE_MODE_BUSB2 | VMRTSTATE_MODE_BUSB3)) >> 11);
+}
+
+const char *RoutingMatrix::busName(uint8_t bus)
+{
+    static const char *const names[NUM_BUSES] = {"A1", "A2", "A3", "A4", "A5", "B1", "B2", "B3"};
+    return bus < NUM_BUSES ? names[bus] : "";
+}
@@ -0,0 +1,15 @@
+#include "StateDiff.h"
+
+const StateChanges &StateDiff::update(const uint32_t stripState[StateChanges::NUM_CHANNELS])
+{
+    changes.strips = 0;
+    for (uint8_t i = 0; i < StateChanges::NUM_CHANNELS; i++)
+    {
+        uint32_t strip = primed ? stripState[i] ^ appliedStrips[i] : ~0u;
+        changes.stripBits[i] = strip;
+        changes.strips |= (strip != 0) << i;
+        appliedStrips[i] = stripState[i];
+    }
+    primed = true;
+    return changes;
+}
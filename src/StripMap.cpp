@@ -0,0 +1,97 @@
+#include "StripMap.h"
+#include "VoicemeeterProtocol.h"
+
+StripMap::StripMap()
+{
+    for (uint8_t slot = 0; slot < STRIP_MAP_SLOTS; slot++)
+    {
+        resolve(slot, defaultEntry(slot));
+        stored[slot] = entries[slot];
+    }
+}
+
+void StripMap::begin()
+{
+    preferences.begin("stripmap", false);
+    StripMapEntry table[STRIP_MAP_SLOTS];
+    bool haveTable = preferences.getBytesLength("table") == sizeof(table) && preferences.getBytes("table", table, sizeof(table)) == sizeof(table);
+    for (uint8_t slot = 0; slot < STRIP_MAP_SLOTS; slot++)
+    {
+        if (haveTable && isValid(table[slot]))
+            resolve(slot, table[slot]);
+        else
+            resolve(slot, defaultEntry(slot));
+        stored[slot] = entries[slot];
+    }
+}
+
+bool StripMap::store(uint8_t slot, const StripMapEntry &entry)
+{
+    if (slot >= STRIP_MAP_SLOTS || !isValid(entry))
+        return false;
+    StripMapEntry previous = stored[slot];
+    stored[slot] = entry;
+    if (preferences.putBytes("table", stored, sizeof(stored)) == sizeof(stored))
+        return true;
+    stored[slot] = previous;
+    return false;
+}
+
+StripMapEntry StripMap::getEntry(uint8_t slot) const
+{
+    return entries[slot];
+}
+
+StripMapEntry StripMap::getStoredEntry(uint8_t slot) const
+{
+    return stored[slot];
+}
+
+const StripMap &StripMap::defaults()
+{
+    static const StripMap map;
+    return map;
+}
+
+StripMapEntry StripMap::defaultEntry(uint8_t slot)
+{
+    uint8_t strip = 5 + slot;
+    return {strip, firstLevelChannel(strip), 0x07};
+}
+
+uint8_t StripMap::firstLevelChannel(uint8_t strip)
+{
+    return strip < 5 ? strip * 2 : 10 + (strip - 5) * 8;
+}
+
+uint32_t StripMap::busStateBit(uint8_t bus)
+{
+    static const uint32_t bits[] = {VMRTSTATE_MODE_BUSA1, VMRTSTATE_MODE_BUSA2, VMRTSTATE_MODE_BUSA3, VMRTSTATE_MODE_BUSA4,
+                                    VMRTSTATE_MODE_BUSA5, VMRTSTATE_MODE_BUSB1, VMRTSTATE_MODE_BUSB2, VMRTSTATE_MODE_BUSB3};
+    return bus < sizeof(bits) / sizeof(bits[0]) ? bits[bus] : 0;
+}
+
+bool StripMap::isValid(const StripMapEntry &entry)
+{
+    uint8_t buses = 0;
+    for (uint8_t mask = entry.busMask; mask; mask &= mask - 1)
+        buses++;
+    return entry.strip < NUM_STRIPS && entry.levelChannel + 1 < NUM_LEVEL_CHANNELS && buses >= STRIP_MAP_BUSES;
+}
+
+void StripMap::resolve(uint8_t slot, const StripMapEntry &entry)
+{
+    entries[slot] = entry;
+    strip[slot] = entry.strip;
+    levelLeft[slot] = entry.levelChannel;
+    levelRight[slot] = entry.levelChannel + 1;
+    uint8_t column = 0;
+    for (uint8_t b = 0; b < 8 && column < STRIP_MAP_BUSES; b++)
+    {
+        if (!(entry.busMask & (1 << b)))
+            continue;
+        bus[slot][column] = b;
+        busBit[slot][column] = busStateBit(b);
+        column++;
+    }
+}
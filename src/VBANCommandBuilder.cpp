@@ -0,0 +1,128 @@
+#include "VBANCommandBuilder.h"
+#include <string.h>
+#include <math.h>
+
+VBANCommandWriter::VBANCommandWriter(char *buffer, size_t capacity) : buffer(buffer), size(capacity), used(0), overflow(false)
+{
+    if (size > 0)
+        buffer[0] = '\0';
+}
+
+void VBANCommandWriter::clear()
+{
+    used = 0;
+    overflow = false;
+    if (size > 0)
+        buffer[0] = '\0';
+}
+
+VBANCommandWriter &VBANCommandWriter::character(char c)
+{
+    if (used + 1 >= size)
+    {
+        overflow = true;
+        return *this;
+    }
+    buffer[used++] = c;
+    buffer[used] = '\0';
+    return *this;
+}
+
+VBANCommandWriter &VBANCommandWriter::text(const char *str)
+{
+    while (*str)
+        character(*str++);
+    return *this;
+}
+
+VBANCommandWriter &VBANCommandWriter::integer(long value)
+{
+    char digits[12];
+    int count = 0;
+    unsigned long magnitude = value < 0 ? -(unsigned long)value : value;
+    do
+    {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0)
+        character('-');
+    while (count)
+        character(digits[--count]);
+    return *this;
+}
+
+VBANCommandWriter &VBANCommandWriter::fixed2(float value)
+{
+    long hundredths = lroundf(value * 100.0f);
+    if (hundredths < 0)
+    {
+        character('-');
+        hundredths = -hundredths;
+    }
+    integer(hundredths / 100);
+    character('.');
+    character('0' + (hundredths / 10) % 10);
+    character('0' + hundredths % 10);
+    return *this;
+}
+
+VBANCommandWriter &VBANCommandWriter::stripGainIncrement(uint8_t strip, float db)
+{
+    return text("strip(").integer(strip).text(").gain += ").fixed2(db);
+}
+
+VBANCommandWriter &VBANCommandWriter::stripGainStep(uint8_t strip, bool up, int db)
+{
+    return text("strip(").integer(strip).text(").gain ").character(up ? '+' : '-').text("= ").integer(db);
+}
+
+VBANCommandWriter &VBANCommandWriter::stripGain(uint8_t strip, float db)
+{
+    return text("Strip[").integer(strip).text("].Gain = ").fixed2(db);
+}
+
+VBANCommandWriter &VBANCommandWriter::stripBus(uint8_t strip, uint8_t bus, bool enabled)
+{
+    text("Strip[").integer(strip).text("].");
+    if (bus < 5)
+        character('A').integer(bus + 1);
+    else
+        character('B').integer(bus - 4);
+    return text(" = ").integer(enabled ? 1 : 0);
+}
+
+VBANTextPacket::VBANTextPacket() : writer((char *)packet + VBAN_HEADER_SIZE, sizeof(packet) - VBAN_HEADER_SIZE)
+{
+    static const uint8_t header[8] = {0x56, 0x42, 0x41, 0x4e, VBAN_PROTOCOL_TXT, 0x00, 0x00, 0x10};
+    memset(packet, 0, VBAN_HEADER_SIZE);
+    memcpy(packet, header, sizeof(header));
+    memcpy(packet + 8, VBAN_TEXT_STREAM_NAME, strlen(VBAN_TEXT_STREAM_NAME));
+}
+
+VBANCommandWriter &VBANTextPacket::begin(uint8_t frameCounter)
+{
+    packet[offsetof(tagVBAN_HEADER, nuFrame)] = frameCounter;
+    writer.clear();
+    return writer;
+}
+
+bool VBANTextPacket::append(const char *statement)
+{
+    // Trim so joined statements read "a; b" rather than "a; ; b"
+    while (*statement == ' ')
+        statement++;
+    size_t length = strlen(statement);
+    while (length > 0 && (statement[length - 1] == ' ' || statement[length - 1] == ';'))
+        length--;
+    if (length == 0)
+        return true;
+    size_t separator = empty() ? 0 : 2;
+    if (writer.length() + separator + length > writer.capacity())
+        return false;
+    if (separator)
+        writer.separator();
+    for (size_t i = 0; i < length; i++)
+        writer.character(statement[i]);
+    return true;
+}
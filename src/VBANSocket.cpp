@@ -0,0 +1,106 @@
+#include "VBANSocket.h"
+#include <lwip/priv/tcpip_priv.h>
+
+// lwIP calls must run on the tcpip thread; these carry the arguments across
+struct BindCall
+{
+    struct tcpip_api_call_data call;
+    struct udp_pcb **pcb;
+    uint16_t port;
+    udp_recv_fn receive;
+    void *receiveArg;
+    err_t result;
+};
+
+struct SendCall
+{
+    struct tcpip_api_call_data call;
+    struct udp_pcb *pcb;
+    struct pbuf *p;
+    ip_addr_t address;
+    uint16_t port;
+    err_t result;
+};
+
+static err_t bindOnTcpip(struct tcpip_api_call_data *data)
+{
+    BindCall *bind = reinterpret_cast<BindCall *>(data);
+    struct udp_pcb *pcb = udp_new();
+    if (!pcb)
+        return bind->result = ERR_MEM;
+    bind->result = udp_bind(pcb, IP_ANY_TYPE, bind->port);
+    if (bind->result != ERR_OK)
+    {
+        udp_remove(pcb);
+        return bind->result;
+    }
+    udp_recv(pcb, bind->receive, bind->receiveArg);
+    *bind->pcb = pcb;
+    return ERR_OK;
+}
+
+static err_t sendOnTcpip(struct tcpip_api_call_data *data)
+{
+    SendCall *send = reinterpret_cast<SendCall *>(data);
+    return send->result = udp_sendto(send->pcb, send->p, &send->address, send->port);
+}
+
+bool VBANSocket::listen(uint16_t port, RTPacketHandler packetHandler, void *handlerContext)
+{
+    if (pcb)
+        return false;
+    handler = packetHandler;
+    context = handlerContext;
+    BindCall bind = {};
+    bind.pcb = &pcb;
+    bind.port = port;
+    bind.receive = receive;
+    bind.receiveArg = this;
+    bind.result = ERR_IF; // stays an error if the call never reaches the tcpip thread
+    if (tcpip_api_call(bindOnTcpip, &bind.call) != ERR_OK || bind.result != ERR_OK)
+        return false;
+    return pcb != nullptr;
+}
+
+size_t VBANSocket::writeTo(const uint8_t *data, size_t length, const IPAddress &address, uint16_t port)
+{
+    if (!pcb || length > 0xFFFF)
+        return 0;
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM);
+    if (!p)
+        return 0;
+    pbuf_take(p, data, length);
+    SendCall send = {};
+    send.pcb = pcb;
+    send.p = p;
+    IP_ADDR4(&send.address, address[0], address[1], address[2], address[3]);
+    send.port = port;
+    send.result = ERR_IF;
+    err_t called = tcpip_api_call(sendOnTcpip, &send.call);
+    pbuf_free(p);
+    return called == ERR_OK && send.result == ERR_OK ? length : 0;
+}
+
+void VBANSocket::receive(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    VBANSocket *self = static_cast<VBANSocket *>(arg);
+    // The header always sits in the first pbuf; the length check covers the whole chain
+    VBANPacketView header(static_cast<const uint8_t *>(p->payload), p->len);
+    bool isRT = p->len >= sizeof(tagVBAN_HEADER) && p->tot_len >= sizeof(tagVBAN_VMRT_PACKET) && header.isVBAN() &&
+                header.protocol() == VBAN_PROTOCOL_SERVICE && header.serviceType() == VBAN_SERVICE_RTPACKET;
+    if (!isRT)
+        self->rejected++;
+    else if (p->len >= sizeof(tagVBAN_VMRT_PACKET))
+    {
+        self->delivered++;
+        self->handler(self->context, VBANPacketView(static_cast<const uint8_t *>(p->payload), p->len));
+    }
+    else
+    {
+        pbuf_copy_partial(p, self->scratch, sizeof(self->scratch), 0);
+        self->delivered++;
+        self->gathered++;
+        self->handler(self->context, VBANPacketView(self->scratch, sizeof(self->scratch)));
+    }
+    pbuf_free(p);
+}
@@ -1310,7 +1310,7 @@
 #endif
 
 /** Interface for TFT_eSPI */
-#define LV_USE_TFT_ESPI         1
+#define LV_USE_TFT_ESPI         0
 
 /** Interface for Lovyan_GFX */
 #define LV_USE_LOVYAN_GFX         0
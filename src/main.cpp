@@ -5,16 +5,105 @@
 #include "NetworkingManager.h"
 #include "DisplayManager.h"
 #include "PowerManager.h"
+#include "FrameProfiler.h"
+#include "StripMap.h"
 
 RotationManager rotationManager;
 DisplayManager displayManager;
 NetworkingManager networkingManager;
 PowerManager powerManager;
-tagVBAN_VMRT_PACKET currentRTPPacket;
+StripMap stripMap;
 
 unsigned long lastInteractionTime = 0;
 
-#define ROTATION_ANGLE_TO_DB_CHANGE 9.0 // degrees
+// "map" lists the strip map, "map <slot> <strip> [<bus mask hex>]" stores a slot for the next boot
+static void handleStripMapCommand(const char *args)
+{
+  unsigned slot, strip, busMask = 0x07;
+  int fields = sscanf(args, "%u %u %x", &slot, &strip, &busMask);
+  if (fields == 1)
+  {
+    Serial.println("Usage: map <slot> <strip> [<bus mask hex>]");
+    return;
+  }
+  if (fields >= 2)
+  {
+    StripMapEntry entry = {(uint8_t)strip, StripMap::firstLevelChannel(strip), (uint8_t)busMask};
+    if (slot > 0xFF || strip > 0xFF || busMask > 0xFF || !stripMap.store(slot, entry))
+      Serial.println("Invalid strip map entry");
+    else
+      Serial.println("Strip map stored, restart to apply");
+    return;
+  }
+  for (uint8_t i = 0; i < STRIP_MAP_SLOTS; i++)
+  {
+    StripMapEntry e = stripMap.getStoredEntry(i);
+    StripMapEntry active = stripMap.getEntry(i);
+    bool pending = memcmp(&e, &active, sizeof(e)) != 0;
+    Serial.printf("slot %u: strip %u, levels %u/%u, buses 0x%02x%s\n", i, e.strip, e.levelChannel, e.levelChannel + 1, e.busMask,
+                  pending ? " (after restart)" : "");
+  }
+}
+
+// "net": RT stream health, to tell Wi-Fi loss from reordering or a throttled Voicemeeter
+static void printLinkStats()
+{
+  const LinkMonitor &link = networkingManager.getLinkMonitor();
+  Serial.printf("RT link %s, packet interval %lu ms, %u recoveries (last took %lu ms)\n", LinkMonitor::stateName(link.getState()),
+                link.getIntervalMs(), link.getRecoveries(), link.getLastRecoveryMs());
+  LinkCounters c = networkingManager.getLinkCounters();
+  Serial.printf("RT packets: %u received, %u accepted, %u lost in %u gaps, %u duplicate, %u reordered, %u resyncs\n",
+                c.received, c.accepted, c.lost, c.gaps, c.duplicates, c.reordered, c.resyncs);
+  Serial.printf("Jitter %u us, max interval %u us, intervals:", c.jitterUs, c.maxIntervalUs);
+  for (uint8_t i = 0; i < LinkCounters::JITTER_BINS; i++)
+  {
+    if (i < LinkCounters::JITTER_BINS - 1)
+      Serial.printf(" <%ums:%u", (LinkStats::FIRST_BIN_US << i) / 1000, c.intervalHistogram[i]);
+    else
+      Serial.printf(" more:%u", c.intervalHistogram[i]);
+  }
+  Serial.println();
+  const VBANSocket &socket = networkingManager.getSocket();
+  Serial.printf("UDP receive: %u delivered, %u rejected, %u gathered from chains; heap %u free, %u minimum\n",
+                socket.getDelivered(), socket.getRejected(), socket.getGathered(), ESP.getFreeHeap(), ESP.getMinFreeHeap());
+  Serial.printf("VBAN-TEXT: %u commands sent in %u datagrams\n", networkingManager.getCommandStatements(), networkingManager.getCommandDatagrams());
+}
+
+// Line-based diagnostics over USB serial, e.g. "prof" to dump the frame profile
+static void handleSerialCommand(const char *line)
+{
+  if (strcmp(line, "prof") == 0)
+    PROFILE_REQUEST_DUMP(DUMP_CSV);
+  else if (strcmp(line, "profbin") == 0)
+    PROFILE_REQUEST_DUMP(DUMP_BINARY);
+  else if (strcmp(line, "net") == 0)
+    printLinkStats();
+  else if (strncmp(line, "map", 3) == 0 && (line[3] == '\0' || line[3] == ' '))
+    handleStripMapCommand(line + 3);
+  else
+    Serial.printf("Unknown command: %s\n", line);
+}
+
+static void pollSerialCommands()
+{
+  static char line[32];
+  static uint8_t length = 0;
+  while (Serial.available() > 0)
+  {
+    char c = Serial.read();
+    if (c == '\r' || c == '\n')
+    {
+      if (length > 0)
+      {
+        line[length] = '\0';
+        handleSerialCommand(line);
+        length = 0;
+      }
+    }
+    else if (length < sizeof(line) - 1)
+      line[length++] = c;
+  }
+}
 
 void setup()
 {
@@ -39,8 +128,15 @@ void setup()
   powerManager.begin(&rotationManager);
   Serial.printf("PowerManager initialized. Millis: %lu\n", millis());
   networkingManager.setupStores();
+  stripMap.begin();
+  networkingManager.setStripMap(&stripMap);
+  displayManager.setStripMap(&stripMap);
   rotationManager.begin();
   Serial.printf("RotationManager initialized. Millis: %lu\n", millis());
+  displayManager.setPacketSource(&networkingManager.getPacketBuffer());
+  displayManager.setMeterSource(&networkingManager.getMeterPeaks());
+  networkingManager.setVisibleChangeCallback([]()
+                                             { DisplayManager::requestFrame(WAKE_PACKET); });
   displayManager.begin(&powerManager, networkingManager.getDestIP());
   Serial.printf("DisplayManager initialized. Millis: %lu\n", millis());
   networkingManager.begin();
@@ -60,26 +156,25 @@ void loop()
   displayManager.setConnectionStatus(networkingManager.isConnected());
 
   networkingManager.update();
-  currentRTPPacket = networkingManager.getCurrentPacket();
-  displayManager.showLatestVoicemeeterData(currentRTPPacket);
+  pollSerialCommands();
   float batteryPercentage = powerManager.getBatteryPercentage();
   int chargeTime = powerManager.getChargeTime();
   displayManager.showLatestBatteryData(batteryPercentage, chargeTime, powerManager.getBatteryVoltage());
 
   auto currentScreen = displayManager.getCurrentScreen();
 
-  float angleDiff = rotationManager.update();
-  if (angleDiff != 0.0f && currentScreen == MONITOR)
+  float dbChange = rotationManager.update(); // filtered and velocity-scaled, see KnobFilter
+  if (dbChange != 0.0f && currentScreen == MONITOR)
   {
-    float dbChange = angleDiff / ROTATION_ANGLE_TO_DB_CHANGE;
-    networkingManager.incrementVolume(displayManager.getSelectedVolumeArc(), dbChange);
+    short selectedArc = displayManager.getSelectedVolumeArc();
+    int16_t targetGain = networkingManager.incrementVolume(selectedArc, dbChange);
+    displayManager.predictVolume(selectedArc, targetGain); // show it now, reconcile when Voicemeeter echoes it
   }
 
-  auto uiCommands = displayManager.getIssuedCommands();
-  for (const auto &cmd : uiCommands)
-  {
+  NetworkCommand cmd;
+  while (displayManager.takeIssuedCommand(cmd))
     networkingManager.sendCommand(cmd);
-  }
+  networkingManager.flushCommands(); // everything issued this frame, in order, in as few datagrams as fit
 
   lastInteractionTime = max(displayManager.getLastTouchTime(), rotationManager.getLastRotationTime());
   powerManager.updateDisplayPowerState(networkingManager.getLastPacketTime(), lastInteractionTime, networkingManager.getConectionStartTime());
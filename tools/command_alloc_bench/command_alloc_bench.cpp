@@ -0,0 +1,163 @@
+/*
+    Allocation count and microbenchmark for the VBAN command builder (src/VBANCommandBuilder.cpp).
+
+    Replaces the global operator new/delete and malloc/calloc/realloc with counting
+    versions, then formats the commands the firmware sends (a knob step with
+    stripGainStep, a gain increment, an absolute gain and a routing toggle with stripBus)
+    into a VBANCommandString and a VBANTextPacket, the way NetworkingManager and
+    DisplayManager do, and batches them with append(). The same commands are also built
+    the way the firmware used to (string concatenation into a heap vector) as a
+    reference, which shows the counter works. Exits non-zero if the builder allocates.
+
+    Build:  g++ -std=gnu++17 -O2 -I include tools/command_alloc_bench/command_alloc_bench.cpp src/VBANCommandBuilder.cpp -o command_alloc_bench
+    Run:    ./command_alloc_bench [--commands 1000000]
+*/
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "VBANCommandBuilder.h"
+
+using Clock = std::chrono::steady_clock;
+
+static unsigned long allocations = 0;
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+extern "C" void *malloc(size_t size)
+{
+    allocations++;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    allocations++;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+
+void *operator new(size_t size)
+{
+    allocations++;
+    if (void *ptr = __libc_malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *ptr) noexcept { __libc_free(ptr); }
+void operator delete[](void *ptr) noexcept { __libc_free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { __libc_free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { __libc_free(ptr); }
+
+// Keeps the optimiser from dropping the built commands
+static volatile size_t sink;
+
+// One of each command the firmware sends, as NetworkingManager::sendVBANCommand would queue it
+static void buildCommands(VBANTextPacket &packet, uint32_t i)
+{
+    uint8_t strip = 5 + i % 3;
+    packet.begin((uint8_t)i);
+
+    VBANCommandString<32> step;
+    step.stripGainStep(strip, i & 1, 3);
+    packet.append(step.c_str());
+
+    VBANCommandString<32> increment;
+    increment.stripGainIncrement(strip, (int)(i % 200 - 100) / 40.0f);
+    packet.append(increment.c_str());
+
+    VBANCommandString<32> gain;
+    gain.stripGain(strip, -(float)(i % 6000) / 100.0f);
+    packet.append(gain.c_str());
+
+    VBANCommandString<32> routing;
+    routing.stripBus(strip, i % 8, i & 2);
+    packet.append(routing.c_str());
+
+    sink = packet.size();
+}
+
+// The pre-builder way: string concatenation and a vector per packet
+static void buildCommandsWithStrings(uint32_t i)
+{
+    uint8_t strip = 5 + i % 3;
+    std::string commands[] = {
+        "strip(" + std::to_string(strip) + ").gain " + ((i & 1) ? "+" : "-") + "= 3",
+        "strip(" + std::to_string(strip) + ").gain += " + std::to_string((int)(i % 200 - 100) / 40.0f),
+        "Strip[" + std::to_string(strip) + "].Gain = " + std::to_string(-(float)(i % 6000) / 100.0f),
+        "Strip[" + std::to_string(strip) + "].A" + std::to_string(i % 5 + 1) + " = " + std::to_string((i >> 1) & 1),
+    };
+    for (const std::string &command : commands)
+    {
+        std::vector<uint8_t> packet(VBAN_HEADER_SIZE);
+        packet.insert(packet.end(), command.begin(), command.end());
+        sink = packet.size();
+    }
+}
+
+template <typename Build>
+static double run(uint32_t commands, unsigned long &allocated, Build build)
+{
+    unsigned long before = allocations;
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < commands / 4; i++)
+        build(i);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    allocated = allocations - before;
+    return ns / commands;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t commands = 1000000;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--commands") && i + 1 < argc)
+            commands = strtoul(argv[++i], nullptr, 10);
+        else
+        {
+            fprintf(stderr, "usage: %s [--commands n]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (commands < 4)
+        commands = 4;
+
+    static VBANTextPacket packet; // a member of NetworkingManager on the device
+    buildCommands(packet, 0);
+    printf("sample packet: %.*s\n", (int)(packet.size() - VBAN_HEADER_SIZE), (const char *)packet.data() + VBAN_HEADER_SIZE);
+
+    unsigned long builderAllocations = 0, stringAllocations = 0;
+    double builderNs = run(commands, builderAllocations, [](uint32_t i)
+                           { buildCommands(packet, i); });
+    double stringNs = run(commands, stringAllocations, buildCommandsWithStrings);
+
+    printf("%-22s %10s %14s %10s\n", "", "commands", "allocations", "ns/cmd");
+    printf("%-22s %10u %14lu %10.1f\n", "VBANCommandWriter", commands, builderAllocations, builderNs);
+    printf("%-22s %10u %14lu %10.1f\n", "string + vector", commands, stringAllocations, stringNs);
+    printf("allocations per command: %.3f (builder), %.3f (string + vector)\n",
+           (double)builderAllocations / commands, (double)stringAllocations / commands);
+
+    bool ok = builderAllocations == 0;
+    printf("%s\n", ok ? "command alloc bench: ok" : "command alloc bench: FAILED, the builder allocated");
+    return ok ? 0 : 1;
+}
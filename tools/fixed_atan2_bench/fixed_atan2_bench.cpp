@@ -0,0 +1,132 @@
+/*
+    Accuracy check and benchmark of fixedAtan2 (src/FixedAngle.cpp) against libm atan2f.
+
+    Sweeps the MLX90393's full int16 X/Y range (every --stride'th value on each axis,
+    --stride 1 is exhaustive), reports the worst and mean error in degrees and the
+    time per call of both implementations, and also checks that angleQ15Delta unwraps
+    across the +-180 boundary. Exits non-zero when the worst error exceeds --max-error.
+
+    Build:  g++ -std=gnu++17 -O2 -I include tools/fixed_atan2_bench/fixed_atan2_bench.cpp src/FixedAngle.cpp -o fixed_atan2_bench
+    Run:    ./fixed_atan2_bench [--stride 16] [--max-error 0.01]
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "FixedAngle.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    int stride = 16;
+    double maxErrorDeg = 0.01;
+};
+
+static bool parseOptions(int argc, char **argv, Options &opts)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--stride") && i + 1 < argc)
+            opts.stride = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--max-error") && i + 1 < argc)
+            opts.maxErrorDeg = atof(argv[++i]);
+        else
+            return false;
+    }
+    return opts.stride > 0;
+}
+
+static double wrapDegrees(double d)
+{
+    while (d > 180.0)
+        d -= 360.0;
+    while (d < -180.0)
+        d += 360.0;
+    return d;
+}
+
+static bool checkAccuracy(const Options &opts)
+{
+    double worst = 0, sum = 0;
+    long count = 0;
+    int worstX = 0, worstY = 0;
+    for (int y = -32768; y <= 32767; y += opts.stride)
+    {
+        for (int x = -32768; x <= 32767; x += opts.stride)
+        {
+            if (x == 0 && y == 0)
+                continue;
+            double reference = atan2((double)y, (double)x) * 180.0 / M_PI;
+            double err = fabs(wrapDegrees(angleQ15ToDegrees(fixedAtan2(y, x)) - reference));
+            sum += err;
+            count++;
+            if (err > worst)
+            {
+                worst = err;
+                worstX = x;
+                worstY = y;
+            }
+        }
+    }
+    printf("accuracy: %ld points, max error %.5f deg at (x=%d, y=%d), mean %.5f deg\n",
+           count, worst, worstX, worstY, sum / count);
+    return worst <= opts.maxErrorDeg;
+}
+
+static bool checkUnwrap()
+{
+    // Crossing 180 degrees either way must come out as a small step, not a full turn
+    struct Case
+    {
+        float fromDeg, toDeg, expectDeg;
+    } cases[] = {{179.0f, -179.0f, 2.0f}, {-179.0f, 179.0f, -2.0f}, {10.0f, 20.0f, 10.0f}, {-5.0f, 5.0f, 10.0f}, {90.0f, -90.0f, -180.0f}};
+    bool ok = true;
+    for (const Case &c : cases)
+    {
+        int16_t d = angleQ15Delta(degreesToAngleQ15(c.fromDeg), degreesToAngleQ15(c.toDeg));
+        if (fabs(angleQ15ToDegrees(d) - c.expectDeg) > 0.01)
+        {
+            printf("unwrap: %.1f -> %.1f gave %.3f, expected %.1f\n", c.fromDeg, c.toDeg, angleQ15ToDegrees(d), c.expectDeg);
+            ok = false;
+        }
+    }
+    printf("unwrap: %s\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+template <typename F>
+static double nsPerCall(F fn, long &sink)
+{
+    const int STEP = 97; // co-prime stride so consecutive inputs are not correlated
+    long calls = 0;
+    auto start = Clock::now();
+    for (int y = -32768; y <= 32767; y += STEP)
+        for (int x = -32768; x <= 32767; x += STEP)
+        {
+            sink += fn(y, x);
+            calls++;
+        }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / calls;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    if (!parseOptions(argc, argv, opts))
+    {
+        fprintf(stderr, "usage: %s [--stride N] [--max-error DEG]\n", argv[0]);
+        return 2;
+    }
+
+    bool ok = checkAccuracy(opts);
+    ok = checkUnwrap() && ok;
+
+    long sink = 0;
+    double fixedNs = nsPerCall([](int y, int x) { return (long)fixedAtan2(y, x); }, sink);
+    double libmNs = nsPerCall([](int y, int x) { return (long)(atan2f((float)y, (float)x) * (32768.0f / (float)M_PI)); }, sink);
+    printf("speed: fixedAtan2 %.2f ns/call, atan2f %.2f ns/call (%.1fx) [%ld]\n", fixedNs, libmNs, libmNs / fixedNs, sink & 1);
+
+    return ok ? 0 : 1;
+}
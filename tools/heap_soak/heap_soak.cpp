@@ -0,0 +1,104 @@
+/*
+    Heap soak for the UDP receive path (src/VBANSocket.cpp) on the native build.
+
+    Runs the firmware's networking loop against lib/NativeHal: NetworkingManager
+    registers with a stand-in Voicemeeter (tools/vm_standin), receives RT packets
+    through VBANSocket and publishes them, a display stand-in acquires them every
+    frame, and a scripted knob sends a gain command every half second. After a warm-up
+    it reads ESP.getFreeHeap(), soaks for --seconds, reads it again and exits non-zero
+    if less heap is free at the end, or if no RT packets arrived. LVGL and the screens
+    are left out so it builds with nothing but g++.
+
+    tools/heap_soak/heap_soak.sh builds both programs and runs them together.
+
+    Build:  g++ -std=gnu++17 -O2 -D NATIVE_HAL -I include -I lib/NativeHal/src tools/heap_soak/heap_soak.cpp src/NetworkingManager.cpp
+              src/VBANSocket.cpp src/VBANCommandBuilder.cpp src/GainAccumulator.cpp src/MeterEngine.cpp src/StripMap.cpp
+              src/LinkStats.cpp src/LinkMonitor.cpp src/RTPacketDelta.cpp lib/NativeHal/src/*.cpp -pthread -o heap_soak
+    Run:    ./heap_soak [--seconds 600] [--warmup 10]
+*/
+#include <Arduino.h>
+#include "NetworkingManager.h"
+
+static NetworkingManager networkingManager;
+static unsigned long soakMs = 600000;
+static unsigned long warmupMs = 10000;
+static unsigned long soakStart;
+static uint32_t heapBefore;
+static uint32_t packetsBefore;
+static uint32_t frames;
+
+static void parseOptions()
+{
+    for (int i = 1; i < NativeHal::getArgc(); i++)
+    {
+        const char *arg = NativeHal::getArgv()[i];
+        bool hasValue = i + 1 < NativeHal::getArgc();
+        if (!strcmp(arg, "--seconds") && hasValue)
+            soakMs = strtoul(NativeHal::getArgv()[++i], nullptr, 10) * 1000;
+        else if (!strcmp(arg, "--warmup") && hasValue)
+            warmupMs = strtoul(NativeHal::getArgv()[++i], nullptr, 10) * 1000;
+        else
+        {
+            fprintf(stderr, "usage: %s [--seconds n] [--warmup n]\n", NativeHal::getArgv()[0]);
+            exit(2);
+        }
+    }
+}
+
+void setup()
+{
+    parseOptions();
+    networkingManager.setupStores();
+    if (!networkingManager.begin())
+    {
+        printf("FAIL the RT socket did not bind\n");
+        exit(1);
+    }
+}
+
+void loop()
+{
+    unsigned long now = millis();
+    networkingManager.update();
+    if (networkingManager.getPacketBuffer().acquire())
+        frames++;
+    static unsigned long nextKnobAt = 0;
+    if ((long)(now - nextKnobAt) >= 0)
+    {
+        networkingManager.incrementVolume(0, (now / 500) % 2 ? 0.5f : -0.5f);
+        nextKnobAt = now + 500;
+    }
+    networkingManager.flushCommands();
+
+    if (!soakStart && now >= warmupMs)
+    {
+        soakStart = now;
+        heapBefore = ESP.getFreeHeap();
+        packetsBefore = networkingManager.getSocket().getDelivered();
+        printf("after %lu s warm-up: heap %u free, %u RT packets\n", warmupMs / 1000, heapBefore, packetsBefore);
+    }
+    else if (soakStart && now - soakStart >= soakMs)
+    {
+        uint32_t heapAfter = ESP.getFreeHeap();
+        const VBANSocket &socket = networkingManager.getSocket();
+        uint32_t packets = socket.getDelivered() - packetsBefore;
+        printf("after %lu s soak: heap %u free (%+d bytes), minimum %u, %u RT packets (%u rejected, %u gathered), %u frames, %u commands\n",
+               soakMs / 1000, heapAfter, (int)(heapAfter - heapBefore), ESP.getMinFreeHeap(), packets, socket.getRejected(),
+               socket.getGathered(), frames, networkingManager.getCommandStatements());
+        bool ok = true;
+        if (heapAfter < heapBefore)
+        {
+            printf("FAIL the heap shrank by %u bytes\n", heapBefore - heapAfter);
+            ok = false;
+        }
+        if (!packets)
+        {
+            printf("FAIL no RT packets arrived (is vm_standin running on 127.0.0.2?)\n");
+            ok = false;
+        }
+        printf("heap soak: %s\n", ok ? "ok" : "FAILED");
+        fflush(stdout);
+        _Exit(ok ? 0 : 1);
+    }
+    delay(16);
+}
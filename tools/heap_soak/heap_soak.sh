@@ -0,0 +1,67 @@
+#!/usr/bin/env bash
+# Heap soak of the RT receive path against tools/vm_standin on loopback.
+#
+# Builds vm_standin and heap_soak (see heap_soak.cpp) with g++, streams RT packets at
+# --rate Hz for --seconds and fails if the free heap is lower at the end than after the
+# warm-up. With FIRMWARE=.pio/build/native/program (pio run -e native) the full native
+# firmware is soaked the same way instead, reading the heap from two "net" reports.
+#
+# Run from the repo root:  tools/heap_soak/heap_soak.sh [--seconds 600] [--rate 50]
+set -euo pipefail
+
+seconds=600
+rate=50
+warmup=10
+while [ $# -gt 0 ]; do
+    case "$1" in
+    --seconds) seconds="$2"; shift 2 ;;
+    --rate) rate="$2"; shift 2 ;;
+    *) echo "usage: $0 [--seconds n] [--rate hz]" >&2; exit 2 ;;
+    esac
+done
+
+work=$(mktemp -d)
+standin=
+cleanup() {
+    [ -n "$standin" ] && kill "$standin" 2>/dev/null || true
+    rm -rf "$work"
+}
+trap cleanup EXIT
+
+g++ -std=gnu++17 -O2 -I include tools/vm_standin/vm_standin.cpp -o "$work/vm_standin" -pthread
+if [ -z "${FIRMWARE:-}" ]; then
+    g++ -std=gnu++17 -O2 -D NATIVE_HAL -I include -I lib/NativeHal/src tools/heap_soak/heap_soak.cpp src/NetworkingManager.cpp \
+        src/VBANSocket.cpp src/VBANCommandBuilder.cpp src/GainAccumulator.cpp src/MeterEngine.cpp src/StripMap.cpp \
+        src/LinkStats.cpp src/LinkMonitor.cpp src/RTPacketDelta.cpp lib/NativeHal/src/*.cpp -pthread -o "$work/heap_soak"
+fi
+
+"$work/vm_standin" --rate "$rate" --quiet > "$work/vm_standin.log" 2>&1 &
+standin=$!
+sleep 0.5
+
+stop_standin() {
+    kill "$standin" && wait "$standin" || true
+    standin=
+    tail -n 2 "$work/vm_standin.log"
+}
+
+if [ -z "${FIRMWARE:-}" ]; then
+    status=0
+    "$work/heap_soak" --seconds "$seconds" --warmup "$warmup" < /dev/null | grep -v '^\[' || status=$?
+    stop_standin
+    exit $status
+fi
+
+(sleep "$warmup"; echo net; sleep "$seconds"; echo net; sleep 1) | timeout $((warmup + seconds + 30)) "$FIRMWARE" > "$work/firmware.log" 2>&1 || true
+heaps=($(sed -n 's/.*heap \([0-9]*\) free.*/\1/p' "$work/firmware.log"))
+stop_standin
+if [ ${#heaps[@]} -lt 2 ]; then
+    echo "FAIL expected two \"net\" reports from $FIRMWARE, got ${#heaps[@]}"
+    exit 1
+fi
+echo "heap ${heaps[0]} free after ${warmup} s warm-up, ${heaps[1]} after ${seconds} s soak ($((heaps[1] - heaps[0])) bytes)"
+if [ "${heaps[1]}" -lt "${heaps[0]}" ]; then
+    echo "FAIL the heap shrank by $((heaps[0] - heaps[1])) bytes"
+    exit 1
+fi
+echo "heap soak: ok"
@@ -0,0 +1,224 @@
+/*
+    Offline replay of rotary encoder traces through KnobFilter (src/KnobFilter.cpp).
+
+    A trace is one "timestampUs,angleQ15" line per sample, the format of the commented-out
+    Serial.printf in RotationManager::update(); lines that do not parse are skipped, so a
+    raw serial log can be fed in directly. The tool prints the gain change the firmware
+    would have sent and how much of it happened while the knob was at rest.
+
+    Without --trace it runs synthetic traces (noisy rest, slow turn, fast sweep, reversal)
+    and the recorded traces in tools/knob_trace/traces (run from the repo root), and exits
+    non-zero if any lands outside its expected range, which makes it usable as a quick
+    check after changing the filter or curve defaults. --filter none has ranges of its
+    own: without filtering, sensor noise reads as speed and the velocity curve inflates it.
+
+    Build:  g++ -std=gnu++17 -O2 -I include tools/knob_trace/knob_trace.cpp src/KnobFilter.cpp -o knob_trace
+    Run:    ./knob_trace [--trace capture.csv] [--filter one-euro|alpha-beta|none] [--noise 0.3]
+*/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include "FixedAngle.h"
+#include "KnobFilter.h"
+
+struct TraceSample
+{
+    uint32_t timestampUs;
+    int16_t angle; // Q15 half turns
+};
+
+struct Options
+{
+    const char *tracePath = nullptr;
+    KnobFilterConfig::FilterType filter = KnobFilterConfig::FILTER_ONE_EURO;
+    double noiseDeg = 0.3;
+};
+
+struct Range
+{
+    double minDb, maxDb; // expected total gain change
+};
+
+struct Scenario
+{
+    const char *name;
+    double restS;         // still time before moving
+    double travelDeg;     // signed rotation
+    double speedDps;      // turning speed
+    double reverseDeg;    // rotation back after the move, 0 for none
+    Range filtered;       // one-euro and alpha-beta
+    Range unfiltered;     // --filter none
+};
+
+struct RecordedTrace
+{
+    const char *path;
+    Range filtered;
+    Range unfiltered;
+    double maxRestDb; // gain change while the knob was still
+};
+
+static bool parseOptions(int argc, char **argv, Options &opts)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--trace") && i + 1 < argc)
+            opts.tracePath = argv[++i];
+        else if (!strcmp(argv[i], "--noise") && i + 1 < argc)
+            opts.noiseDeg = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+        {
+            const char *name = argv[++i];
+            if (!strcmp(name, "one-euro"))
+                opts.filter = KnobFilterConfig::FILTER_ONE_EURO;
+            else if (!strcmp(name, "alpha-beta"))
+                opts.filter = KnobFilterConfig::FILTER_ALPHA_BETA;
+            else if (!strcmp(name, "none"))
+                opts.filter = KnobFilterConfig::FILTER_NONE;
+            else
+                return false;
+        }
+        else
+            return false;
+    }
+    return true;
+}
+
+static bool loadTrace(const char *path, std::vector<TraceSample> &trace)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+    {
+        unsigned long ts;
+        int angle;
+        if (sscanf(line, "%lu,%d", &ts, &angle) == 2)
+            trace.push_back({static_cast<uint32_t>(ts), static_cast<int16_t>(angle)});
+    }
+    fclose(f);
+    return true;
+}
+
+// Replays the trace the way RotationManager::update() does, draining every 16 ms like loop()
+static double replay(const std::vector<TraceSample> &trace, const KnobFilterConfig &config, double *restDb)
+{
+    KnobFilter filter(config);
+    double total = 0;
+    if (restDb)
+        *restDb = 0;
+    uint32_t nextDrainUs = trace.empty() ? 0 : trace.front().timestampUs + 16000;
+    for (size_t i = 1; i < trace.size(); i++)
+    {
+        int16_t diff = angleQ15Delta(trace[i - 1].angle, trace[i].angle);
+        filter.addSample(trace[i].timestampUs, angleQ15ToDegrees(diff));
+        if (trace[i].timestampUs >= nextDrainUs || i + 1 == trace.size())
+        {
+            double db = filter.takeDb();
+            total += db;
+            if (restDb && fabs(filter.getSpeedDps()) < 2.0)
+                *restDb += fabs(db);
+            nextDrainUs = trace[i].timestampUs + 16000;
+        }
+    }
+    return total;
+}
+
+static std::vector<TraceSample> synthesize(const Scenario &s, double noiseDeg, std::mt19937 &rng)
+{
+    const double RATE_HZ = 200.0;
+    const double SETTLE_S = 1.0;
+    std::normal_distribution<double> noise(0.0, noiseDeg);
+    std::vector<TraceSample> trace;
+    double moveS = fabs(s.travelDeg) / s.speedDps;
+    double backS = fabs(s.reverseDeg) / s.speedDps;
+    double totalS = s.restS + moveS + backS + SETTLE_S;
+    for (double t = 0; t < totalS; t += 1.0 / RATE_HZ)
+    {
+        double angle;
+        if (t < s.restS)
+            angle = 0;
+        else if (t < s.restS + moveS)
+            angle = s.travelDeg * (t - s.restS) / moveS;
+        else if (t < s.restS + moveS + backS)
+            angle = s.travelDeg - copysign(1.0, s.travelDeg) * s.reverseDeg * (t - s.restS - moveS) / backS;
+        else
+            angle = s.travelDeg - copysign(1.0, s.travelDeg) * s.reverseDeg;
+        angle += 123.0 + noise(rng); // arbitrary mounting offset; wraps through 180 for large moves
+        trace.push_back({static_cast<uint32_t>(t * 1e6), static_cast<int16_t>(degreesToAngleQ15(remainder(angle, 360.0)))});
+    }
+    return trace;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    if (!parseOptions(argc, argv, opts))
+    {
+        fprintf(stderr, "usage: %s [--trace FILE] [--filter one-euro|alpha-beta|none] [--noise DEG]\n", argv[0]);
+        return 2;
+    }
+    KnobFilterConfig config;
+    config.type = opts.filter;
+
+    if (opts.tracePath)
+    {
+        std::vector<TraceSample> trace;
+        if (!loadTrace(opts.tracePath, trace))
+        {
+            perror(opts.tracePath);
+            return 2;
+        }
+        double restDb;
+        double total = replay(trace, config, &restDb);
+        printf("%zu samples: total %+.2f dB, %.2f dB while at rest\n", trace.size(), total, restDb);
+        return 0;
+    }
+
+    // Expected ranges follow the default curve: 9 deg/dB, 0.5x below 30 deg/s, 4x from 360 deg/s
+    const Scenario scenarios[] = {
+        {"rest", 5.0, 0, 1, 0, {-0.05, 0.05}, {-0.2, 0.2}},
+        {"slow turn", 0.5, 90, 15, 0, {4.0, 5.2}, {10.0, 18.0}},
+        {"medium turn", 0.5, -90, 120, 0, {-15.5, -10.0}, {-26.0, -16.0}},
+        {"fast sweep", 0.5, 540, 720, 0, {200.0, 245.0}, {200.0, 250.0}},
+        {"reversal", 0.5, 45, 15, 20, {1.0, 1.6}, {2.5, 5.5}},
+    };
+    const RecordedTrace recorded[] = {
+        {"tools/knob_trace/traces/native_session.csv", {85.0, 105.0}, {85.0, 110.0}, 0.1},
+    };
+    bool unfiltered = config.type == KnobFilterConfig::FILTER_NONE;
+
+    std::mt19937 rng(1234);
+    bool ok = true;
+    for (const Scenario &s : scenarios)
+    {
+        std::vector<TraceSample> trace = synthesize(s, opts.noiseDeg, rng);
+        double total = replay(trace, config, nullptr);
+        const Range &r = unfiltered ? s.unfiltered : s.filtered;
+        bool pass = total >= r.minDb && total <= r.maxDb;
+        ok = ok && pass;
+        printf("%-12s %+8.2f dB  expected [%+.2f, %+.2f]  %s\n", s.name, total, r.minDb, r.maxDb, pass ? "ok" : "FAILED");
+    }
+    for (const RecordedTrace &t : recorded)
+    {
+        std::vector<TraceSample> trace;
+        if (!loadTrace(t.path, trace) || trace.empty())
+        {
+            printf("%s: cannot read the trace (run from the repo root)  FAILED\n", t.path);
+            ok = false;
+            continue;
+        }
+        double restDb;
+        double total = replay(trace, config, &restDb);
+        const Range &r = unfiltered ? t.unfiltered : t.filtered;
+        bool pass = total >= r.minDb && total <= r.maxDb && restDb <= t.maxRestDb;
+        ok = ok && pass;
+        printf("%s: %+.2f dB expected [%+.2f, %+.2f], %.2f dB at rest (max %.2f)  %s\n", t.path, total, r.minDb, r.maxDb, restDb,
+               t.maxRestDb, pass ? "ok" : "FAILED");
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/*
+    Outage simulation for LinkMonitor (src/LinkMonitor.cpp).
+
+    Runs the real state machine against a simulated Voicemeeter that streams RT packets
+    every --interval ms while a registration (15 s, like VBAN_RT_REGISTER_PACKET) is
+    live, with update() called at the firmware's 16 ms loop rate. Each scenario starts
+    from a settled stream, injects one outage and records how long after the outage
+    ended the monitor was streaming again, how long the display would have shown the
+    Loading screen, and how many register packets went out. A last check stamps a packet
+    just after the loop's now, as the receive task can. Exits non-zero when any recovery
+    takes longer than --max-recovery ms or that packet drops the stream.
+
+    Build:  g++ -std=gnu++17 -O2 -I include tools/link_recovery/link_recovery.cpp src/LinkMonitor.cpp -o link_recovery
+    Run:    ./link_recovery [--interval 20] [--max-recovery 2500]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LinkMonitor.h"
+
+static const unsigned long LOOP_MS = 16;
+static const unsigned long REGISTRATION_MS = 15000;
+static const unsigned long SETTLE_MS = 30000;
+static const unsigned long RUN_AFTER_MS = 30000;
+
+struct Options
+{
+    unsigned long intervalMs = 20;
+    unsigned long maxRecoveryMs = LinkMonitor::BACKOFF_MAX_MS + 500; // one backoff step plus a few packets
+};
+
+enum OutageKind
+{
+    WIFI_DOWN,          // station disconnects and reconnects
+    PACKETS_DROPPED,    // Wi-Fi stays up, nothing gets through either way
+    VOICEMEETER_RESTART // stream stops and the registration is forgotten
+};
+
+struct Scenario
+{
+    const char *name;
+    OutageKind kind;
+    unsigned long durationMs;
+};
+
+struct Result
+{
+    long recoveryMs = -1;         // outage end to streaming, -1 if never
+    unsigned long loadingMs = 0; // time isConnected() was false
+    unsigned registers = 0;      // from the outage start until recovery
+};
+
+static Result run(const Scenario &scenario, const Options &opts)
+{
+    LinkMonitor monitor;
+    Result result;
+    uint32_t packets = 0;
+    unsigned long lastPacketMs = 0;
+    unsigned long registeredUntil = 0;
+    unsigned long nextPacketAt = 0;
+    const unsigned long outageStart = SETTLE_MS;
+    const unsigned long outageEnd = outageStart + scenario.durationMs;
+    bool registrationCleared = false;
+
+    for (unsigned long now = 1; now < outageEnd + RUN_AFTER_MS; now++)
+    {
+        bool inOutage = now >= outageStart && now < outageEnd;
+        bool wifiUp = !(inOutage && scenario.kind == WIFI_DOWN);
+        bool pathUp = !inOutage; // every outage kind stops traffic
+        if (inOutage && scenario.kind == VOICEMEETER_RESTART && !registrationCleared)
+        {
+            registeredUntil = 0;
+            registrationCleared = true;
+        }
+
+        if (pathUp && now < registeredUntil && (long)(now - nextPacketAt) >= 0)
+        {
+            packets++;
+            lastPacketMs = now;
+            nextPacketAt = now + opts.intervalMs;
+        }
+
+        if (now % LOOP_MS)
+            continue;
+        if (monitor.update(now, packets, lastPacketMs, wifiUp))
+        {
+            if (now >= outageStart && result.recoveryMs < 0)
+                result.registers++;
+            if (pathUp)
+                registeredUntil = now + REGISTRATION_MS;
+        }
+        if (now >= outageStart)
+        {
+            if (!monitor.isConnected())
+                result.loadingMs += LOOP_MS;
+            if (now >= outageEnd && result.recoveryMs < 0 && monitor.getState() == LINK_STREAMING)
+                result.recoveryMs = now - outageEnd;
+        }
+    }
+    return result;
+}
+
+// The receive task can stamp lastPacketMs between the loop reading millis() and calling update();
+// that packet is newer than now and must not read as a silence of nearly 2^32 ms
+static bool lateStampKeepsStreaming()
+{
+    LinkMonitor monitor;
+    uint32_t packets = 0;
+    unsigned long now = 1000;
+    for (; now < 3000; now += LOOP_MS)
+        monitor.update(now, ++packets, now, true);
+    monitor.update(now, packets, now + 3, true);
+    return monitor.getState() == LINK_STREAMING;
+}
+
+static bool parseOptions(int argc, char **argv, Options &opts)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--interval") && i + 1 < argc)
+            opts.intervalMs = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--max-recovery") && i + 1 < argc)
+            opts.maxRecoveryMs = strtoul(argv[++i], nullptr, 10);
+        else
+            return false;
+    }
+    return opts.intervalMs > 0;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    if (!parseOptions(argc, argv, opts))
+    {
+        fprintf(stderr, "usage: %s [--interval ms] [--max-recovery ms]\n", argv[0]);
+        return 2;
+    }
+
+    static const Scenario scenarios[] = {
+        {"wifi blip 1 s", WIFI_DOWN, 1000},
+        {"wifi down 12 s", WIFI_DOWN, 12000},
+        {"packet loss 200 ms", PACKETS_DROPPED, 200},
+        {"packet loss 1 s", PACKETS_DROPPED, 1000},
+        {"packet loss 8 s", PACKETS_DROPPED, 8000},
+        {"packet loss 20 s", PACKETS_DROPPED, 20000}, // outlasts the registration
+        {"voicemeeter restart 5 s", VOICEMEETER_RESTART, 5000},
+    };
+
+    int failures = 0;
+    printf("%-26s %12s %12s %10s\n", "scenario", "recovery ms", "loading ms", "registers");
+    for (const Scenario &scenario : scenarios)
+    {
+        Result r = run(scenario, opts);
+        bool ok = r.recoveryMs >= 0 && (unsigned long)r.recoveryMs <= opts.maxRecoveryMs;
+        failures += !ok;
+        printf("%-26s %12ld %12lu %10u%s\n", scenario.name, r.recoveryMs, r.loadingMs, r.registers, ok ? "" : "  FAIL");
+    }
+    bool lateStampOk = lateStampKeepsStreaming();
+    failures += !lateStampOk;
+    printf("%-26s %s\n", "packet stamped after now", lateStampOk ? "still streaming" : "left streaming  FAIL");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,386 @@
+/*
+    Delayed/lossy link test for PredictedState (src/PredictedState.cpp).
+
+    Simulates, in 1 ms steps, a Voicemeeter that applies gain and routing commands and
+    streams RT packets every 20 ms, and the firmware side that issues those commands,
+    keeps the newest RT packet LinkStats accepts and reconciles PredictedState against
+    it once per 16 ms display frame. Both directions of the link add --delay ms plus up
+    to --jitter ms, lose --loss percent of everything, and hold --reorder percent of the
+    RT packets back by two packet intervals so they arrive out of order.
+
+    Checks, for gain and routing predictions:
+      - confirm:  a delivered command is shown from the moment it is issued until an RT
+                  packet confirms it, without flicking back, and nothing is rolled back
+      - rollback: a lost command, or one Voicemeeter applies differently (a gain it
+                  clamps), is rolled back to the reported value after GRACE_FRAMES
+      - timeout:  with the RT stream gone, a prediction is dropped after TIMEOUT_MS
+    and a soak of --commands random commands on random strips, each expected to end
+    in exactly one confirm or rollback depending on its fate. The confirm checks assume
+    the round trip stays under GRACE_FRAMES packet intervals. Exits non-zero on failure.
+
+    Build:  g++ -std=gnu++17 -O2 -I include tools/predicted_link/predicted_link.cpp src/PredictedState.cpp src/LinkStats.cpp -o predicted_link
+    Run:    ./predicted_link [--delay 30] [--jitter 20] [--loss 5] [--reorder 10] [--commands 500] [--seed 1]
+*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include "PredictedState.h"
+#include "LinkStats.h"
+
+static const unsigned long PACKET_INTERVAL_MS = 20;
+static const unsigned long FRAME_MS = 16; // display task frame
+static const unsigned long WARMUP_MS = 500;
+static const int16_t GAIN_MIN_DB100 = -6000;
+static const int16_t GAIN_MAX_DB100 = 1200;
+
+struct Options
+{
+    unsigned long delayMs = 30;
+    unsigned long jitterMs = 20;
+    unsigned int lossPercent = 5;
+    unsigned int reorderPercent = 10;
+    unsigned int commands = 500;
+    unsigned int seed = 1;
+};
+
+struct Command
+{
+    bool routing;
+    uint8_t strip;
+    int16_t gainDb100;
+    uint32_t stateMask;
+    bool enabled;
+};
+
+// One direction of the link
+template <typename T>
+class Link
+{
+public:
+    Link(const Options &opts, std::mt19937 &rng, bool reorders) : opts(opts), rng(rng), reorders(reorders) {}
+
+    // Returns false when the item was lost on the way
+    bool send(const T &item, unsigned long now, bool drop = false)
+    {
+        if (down || drop || percent() < opts.lossPercent)
+            return false;
+        unsigned long at = now + opts.delayMs + rng() % (opts.jitterMs + 1);
+        if (reorders && percent() < opts.reorderPercent)
+            at += 2 * PACKET_INTERVAL_MS;
+        queue.push_back({at, item});
+        return true;
+    }
+
+    // Earliest item due by now
+    bool receive(unsigned long now, T &out)
+    {
+        size_t earliest = queue.size();
+        for (size_t i = 0; i < queue.size(); i++)
+            if (queue[i].at <= now && (earliest == queue.size() || queue[i].at < queue[earliest].at))
+                earliest = i;
+        if (earliest == queue.size())
+            return false;
+        out = queue[earliest].item;
+        queue.erase(queue.begin() + earliest);
+        return true;
+    }
+
+    bool down = false; // drops everything sent from now on
+
+private:
+    struct InFlight
+    {
+        unsigned long at;
+        T item;
+    };
+
+    unsigned int percent() { return rng() % 100; }
+
+    const Options &opts;
+    std::mt19937 &rng;
+    bool reorders;
+    std::vector<InFlight> queue;
+};
+
+static void setGain(tagVBAN_VMRT_PACKET &packet, uint8_t strip, int16_t gainDb100)
+{
+    uint8_t *layers = reinterpret_cast<uint8_t *>(&packet) + offsetof(tagVBAN_VMRT_PACKET, stripGaindB100Layer1);
+    memcpy(layers + VMRT_STRIP_GAIN_INDEX(strip) * sizeof(int16_t), &gainDb100, sizeof(gainDb100));
+}
+
+class Simulation
+{
+public:
+    Simulation(const Options &opts) : rng(opts.seed), commandLink(opts, rng, false), rtLink(opts, rng, true)
+    {
+        memset(&mixer, 0, sizeof(mixer));
+        memset(&latest, 0, sizeof(latest));
+        for (uint8_t strip = 0; strip < PredictedState::NUM_STRIPS; strip++)
+            setGain(mixer, strip, -1200);
+        run(WARMUP_MS);
+    }
+
+    // Issues a command the way DisplayManager and the loop do: predict, then send
+    bool issue(const Command &c, bool drop = false)
+    {
+        if (c.routing)
+            predicted.predictRouting(c.strip, c.stateMask, c.enabled, latest.frameCounter, now);
+        else
+            predicted.predictGain(c.strip, c.gainDb100, latest.frameCounter, now);
+        return commandLink.send(c, now, drop);
+    }
+
+    void step()
+    {
+        now++;
+        Command c;
+        while (commandLink.receive(now, c))
+            apply(c);
+        if (now % PACKET_INTERVAL_MS == 0)
+        {
+            mixer.frameCounter++;
+            rtLink.send(mixer, now);
+        }
+        tagVBAN_VMRT_PACKET packet;
+        while (rtLink.receive(now, packet))
+            if (stats.check(packet.frameCounter, now * 1000) == LinkStats::ACCEPT)
+                latest = packet;
+        if (now % FRAME_MS == 0)
+            predicted.reconcile(latest, now);
+    }
+
+    void run(unsigned long ms)
+    {
+        for (unsigned long i = 0; i < ms; i++)
+            step();
+    }
+
+    int16_t shownGain(uint8_t strip) const { return predicted.stripGain(latest, strip); }
+    uint32_t shownState(uint8_t strip) const { return predicted.stripState(latest, strip); }
+    int16_t mixerGain(uint8_t strip) const { return vmrtStripGain(mixer, strip); }
+    uint32_t mixerState(uint8_t strip) const { return mixer.stripState[strip]; }
+
+    std::mt19937 rng;
+    Link<Command> commandLink;
+    Link<tagVBAN_VMRT_PACKET> rtLink;
+    PredictedState predicted;
+    LinkStats stats;
+    unsigned long now = 0;
+
+private:
+    // Voicemeeter's side: clamps gains to its range
+    void apply(const Command &c)
+    {
+        if (c.routing)
+            mixer.stripState[c.strip] = c.enabled ? (mixer.stripState[c.strip] | c.stateMask) : (mixer.stripState[c.strip] & ~c.stateMask);
+        else
+            setGain(mixer, c.strip, c.gainDb100 < GAIN_MIN_DB100 ? GAIN_MIN_DB100 : c.gainDb100 > GAIN_MAX_DB100 ? GAIN_MAX_DB100 : c.gainDb100);
+    }
+
+    tagVBAN_VMRT_PACKET mixer;  // Voicemeeter's state
+    tagVBAN_VMRT_PACKET latest; // newest RT packet on the firmware side
+};
+
+static int failures = 0;
+
+static void fail(const char *scenario, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    printf("FAIL %s: ", scenario);
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+    failures++;
+}
+
+struct Outcome
+{
+    bool resolved = false;
+    bool rolledBack = false;
+    bool flicked = false; // the display showed something other than the prediction before it resolved
+    unsigned long resolveMs = 0;
+};
+
+static bool showsCommand(const Simulation &sim, const Command &c)
+{
+    if (c.routing)
+        return (sim.shownState(c.strip) & c.stateMask) == (c.enabled ? c.stateMask : 0);
+    return sim.shownGain(c.strip) == c.gainDb100;
+}
+
+// Issues one command and follows it until the prediction is confirmed or rolled back
+static Outcome follow(Simulation &sim, const Command &c, bool drop, unsigned long limitMs = 3000)
+{
+    Outcome o;
+    uint32_t rollbacks = sim.predicted.getRollbackCount();
+    unsigned long issued = sim.now;
+    sim.issue(c, drop);
+    while (sim.now - issued < limitMs)
+    {
+        if (!showsCommand(sim, c))
+            o.flicked = true;
+        sim.step();
+        if (sim.predicted.inFlightCount() == 0)
+        {
+            o.resolved = true;
+            o.rolledBack = sim.predicted.getRollbackCount() != rollbacks;
+            o.resolveMs = sim.now - issued;
+            break;
+        }
+    }
+    return o;
+}
+
+static void expectConfirm(const char *name, Simulation &sim, const Command &c, unsigned long maxMs)
+{
+    Outcome o = follow(sim, c, false);
+    printf("%-24s confirmed after %4lu ms\n", name, o.resolveMs);
+    if (!o.resolved || o.rolledBack)
+        fail(name, "expected a confirm, got %s", o.resolved ? "a rollback" : "nothing");
+    else if (o.flicked)
+        fail(name, "the display fell back to the old value before the confirm");
+    else if (o.resolveMs > maxMs)
+        fail(name, "confirm took %lu ms, limit %lu", o.resolveMs, maxMs);
+    if (!showsCommand(sim, c))
+        fail(name, "confirmed value not shown");
+}
+
+static void expectRollback(const char *name, Simulation &sim, const Command &c, bool drop, unsigned long minMs, unsigned long maxMs)
+{
+    Outcome o = follow(sim, c, drop);
+    printf("%-24s rolled back after %4lu ms\n", name, o.resolveMs);
+    if (!o.resolved || !o.rolledBack)
+        fail(name, "expected a rollback, got %s", o.resolved ? "a confirm" : "nothing");
+    else if (o.flicked)
+        fail(name, "the prediction was not shown until the rollback");
+    else if (o.resolveMs < minMs || o.resolveMs > maxMs)
+        fail(name, "rollback after %lu ms, expected %lu..%lu", o.resolveMs, minMs, maxMs);
+    sim.run(200); // let the last packets in flight arrive
+    if (sim.shownGain(c.strip) != sim.mixerGain(c.strip) || sim.shownState(c.strip) != sim.mixerState(c.strip))
+        fail(name, "display does not show Voicemeeter's state after the rollback");
+}
+
+static Command gainCommand(uint8_t strip, int16_t gainDb100) { return {false, strip, gainDb100, 0, false}; }
+static Command routingCommand(uint8_t strip, uint32_t stateMask, bool enabled) { return {true, strip, 0, stateMask, enabled}; }
+
+static void runScenarios(const Options &opts)
+{
+    // Worst case round trip, plus waiting for the next packet and display frame
+    unsigned long oneWayMs = opts.delayMs + opts.jitterMs + 2 * PACKET_INTERVAL_MS;
+    unsigned long confirmMaxMs = 2 * oneWayMs + PACKET_INTERVAL_MS + FRAME_MS;
+    // GRACE_FRAMES newer frames have to arrive, give or take jitter and a display frame
+    unsigned long graceMs = PredictedState::GRACE_FRAMES * PACKET_INTERVAL_MS;
+    unsigned long rollbackMinMs = graceMs > opts.jitterMs + PACKET_INTERVAL_MS ? graceMs - opts.jitterMs - PACKET_INTERVAL_MS : 0;
+    unsigned long rollbackMaxMs = graceMs + 2 * PACKET_INTERVAL_MS + opts.jitterMs + FRAME_MS + oneWayMs;
+
+    Options lossless = opts;
+    lossless.lossPercent = 0; // the command's own fate is decided by the scenario
+
+    {
+        Simulation sim(lossless);
+        expectConfirm("gain confirmed", sim, gainCommand(5, -300), confirmMaxMs);
+        expectConfirm("routing confirmed", sim, routingCommand(6, VMRTSTATE_MODE_BUSA1, true), confirmMaxMs);
+        expectRollback("gain lost", sim, gainCommand(7, 600), true, rollbackMinMs, rollbackMaxMs);
+        expectRollback("routing lost", sim, routingCommand(5, VMRTSTATE_MODE_BUSB2, true), true, rollbackMinMs, rollbackMaxMs);
+        expectRollback("gain clamped", sim, gainCommand(6, 1500), false, rollbackMinMs, rollbackMaxMs);
+        if (sim.shownGain(6) != GAIN_MAX_DB100)
+            fail("gain clamped", "shows %d after the rollback, Voicemeeter has %d", sim.shownGain(6), GAIN_MAX_DB100);
+    }
+
+    {
+        // The link drops: no newer frame ever arrives, so only TIMEOUT_MS can end the prediction
+        Simulation sim(lossless);
+        sim.rtLink.down = true;
+        sim.commandLink.down = true;
+        sim.run(oneWayMs + PACKET_INTERVAL_MS);
+        expectRollback("gain, link down", sim, gainCommand(5, 0), false, PredictedState::TIMEOUT_MS, PredictedState::TIMEOUT_MS + FRAME_MS + 1);
+    }
+}
+
+// Random commands on random strips over the lossy link, spaced so each resolves before the next
+static void runSoak(const Options &opts)
+{
+    Simulation sim(opts);
+    std::mt19937 pick(opts.seed + 1);
+    unsigned long spacingMs = 2 * (PredictedState::GRACE_FRAMES * PACKET_INTERVAL_MS) + 2 * (opts.delayMs + opts.jitterMs);
+    unsigned int confirms = 0, rollbacks = 0, wrong = 0, flicks = 0;
+    for (unsigned int i = 0; i < opts.commands; i++)
+    {
+        uint8_t strip = pick() % PredictedState::NUM_STRIPS;
+        Command c;
+        if (pick() % 2)
+            c = routingCommand(strip, VMRTSTATE_MODE_BUSA1 << (pick() % 4), !(sim.shownState(strip) & (VMRTSTATE_MODE_BUSA1 << (pick() % 4))));
+        else
+            c = gainCommand(strip, (int16_t)(GAIN_MIN_DB100 + (int)(pick() % 8000))); // up to 8 dB past the top, which Voicemeeter clamps
+        bool already = showsCommand(sim, c);
+        uint32_t before = sim.predicted.getRollbackCount();
+        unsigned long issued = sim.now;
+        bool delivered = sim.issue(c);
+        bool clamped = !c.routing && c.gainDb100 > GAIN_MAX_DB100;
+        bool flicked = false;
+        while (sim.now - issued < spacingMs)
+        {
+            if (sim.predicted.inFlightCount() && !showsCommand(sim, c))
+                flicked = true;
+            sim.step();
+        }
+        bool rolledBack = sim.predicted.getRollbackCount() != before;
+        bool expectRollback = (!delivered && !already) || clamped;
+        confirms += !rolledBack;
+        rollbacks += rolledBack;
+        wrong += rolledBack != expectRollback || sim.predicted.inFlightCount() != 0;
+        flicks += flicked;
+    }
+    printf("soak: %u commands, %u confirmed, %u rolled back, %u resolved wrongly, %u shown late, %u RT packets reordered\n",
+           opts.commands, confirms, rollbacks, wrong, flicks, sim.stats.getCounters().reordered);
+    if (wrong)
+        fail("soak", "%u commands did not end as their delivery predicted", wrong);
+    if (flicks)
+        fail("soak", "%u predictions were not shown until they resolved", flicks);
+}
+
+static bool parseOptions(int argc, char **argv, Options &opts)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc)
+            return false;
+        unsigned long value = strtoul(argv[i + 1], nullptr, 10);
+        if (!strcmp(argv[i], "--delay"))
+            opts.delayMs = value;
+        else if (!strcmp(argv[i], "--jitter"))
+            opts.jitterMs = value;
+        else if (!strcmp(argv[i], "--loss"))
+            opts.lossPercent = value;
+        else if (!strcmp(argv[i], "--reorder"))
+            opts.reorderPercent = value;
+        else if (!strcmp(argv[i], "--commands"))
+            opts.commands = value;
+        else if (!strcmp(argv[i], "--seed"))
+            opts.seed = value;
+        else
+            return false;
+        i++;
+    }
+    return opts.lossPercent < 100;
+}
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    if (!parseOptions(argc, argv, opts))
+    {
+        fprintf(stderr, "usage: %s [--delay ms] [--jitter ms] [--loss %%] [--reorder %%] [--commands n] [--seed n]\n", argv[0]);
+        return 2;
+    }
+    printf("link: %lu ms + up to %lu ms jitter, %u%% loss, %u%% of RT packets reordered\n",
+           opts.delayMs, opts.jitterMs, opts.lossPercent, opts.reorderPercent);
+    runScenarios(opts);
+    runSoak(opts);
+    printf("%s\n", failures ? "predicted link: FAILED" : "predicted link: ok");
+    return failures ? 1 : 0;
+}
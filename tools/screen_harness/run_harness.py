@@ -0,0 +1,17 @@
+# PlatformIO extra script for env:native-screens: runs the harness after the program is built, on
+# every `pio run -e native-screens` (also when nothing was relinked), so a screen that does not
+# settle or no longer matches its golden fails the build.
+import subprocess
+
+Import("env")
+
+
+def run_harness(target, source, env):
+    program = source[0].get_abspath()
+    print("Running %s" % program)
+    return subprocess.call([program], cwd=env.subst("$PROJECT_DIR"))
+
+
+harness = env.Alias("screen_harness", "$BUILD_DIR/${PROGNAME}${PROGSUFFIX}", run_harness)
+env.AlwaysBuild(harness)
+env.Default(harness)
@@ -0,0 +1,549 @@
+/*
+    Off-screen render harness for the SquareLine screens.
+
+    Runs the real DisplayManager (display task, LVGL with src/lv_conf.h, DmaDisplayDriver)
+    against the NativeHal framebuffer and walks it through Loading, Monitor, OutputMatrix
+    and Config with synthetic RT packets and touch input. Every scenario has to settle
+    (nothing flushed for SETTLE_MS); its frame cost (frames, pixels flushed per frame,
+    render time per frame) is printed, the settled framebuffer is compared with a golden
+    image and the frame cost with a baseline.
+
+    Build:  pio run -e native-screens (also runs the harness, and fails when it exits non-zero)
+    Run:    .pio/build/native-screens/program [--update] [--golden DIR] [--out DIR]
+                [--max-diff-pixels N] [--cost-tolerance PERCENT] [--check-time]
+
+    --update writes DIR/<scenario>.ppm and DIR/costs.csv from this run (DIR defaults to
+    tools/screen_harness/golden); commit them when a visual or cost change is intended.
+    Without --update the run exits with status 1 if DIR, a golden image or a scenario's
+    line in costs.csv is missing, if a screen differs in more than --max-diff-pixels
+    pixels (default 0; <scenario>.ppm and a red <scenario>.diff.ppm land in --out), or
+    if pixels per frame grew by more than --cost-tolerance percent (default 10). Render time depends on the host and is only
+    checked with --check-time. A scenario that never settles always fails.
+
+    Before the walk-through, the Monitor ring geometries are drawn once by LVGL
+    (lv_draw_arc) and once through RingMaskCache, on a display of their own. At most
+    ARC_MAX_DIFF_PERCENT (1%) of the pixels either of them drew may differ by more than
+    ARC_CHANNEL_TOLERANCE (32 of 255) in a colour channel: both anti-alias the ring
+    edges and the flat ends, but round them differently. The cached drawing must also
+    have been used, not the lv_draw_arc fallback.
+*/
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include "NativeHal.h"
+#include "DisplayManager.h"
+#include "PowerManager.h"
+#include "RingMaskCache.h"
+
+static const unsigned long PACKET_INTERVAL_MS = 20; // Voicemeeter's RT stream runs at about 50 Hz
+static const unsigned long SETTLE_MS = 1000;        // longer than ACTIVE_HOLD_MS plus a touch poll
+static const unsigned long SETTLE_TIMEOUT_MS = 15000;
+static const uint8_t ARC_CHANNEL_TOLERANCE = 32;
+static const float ARC_MAX_DIFF_PERCENT = 1.0f;
+
+static const char *goldenDir = "tools/screen_harness/golden";
+static const char *outDir = "/tmp";
+static bool updateGoldens = false;
+static bool haveGoldens = false; // goldenDir exists, or is being recorded; a missing one fails the run once
+static bool checkTime = false;
+static uint32_t maxDiffPixels = 0;
+static float costTolerance = 10.0f;
+
+static PowerManager powerManager; // never begun: display on, full frame rate
+static DisplayManager displayManager;
+static TripleBuffer<RTSnapshot> packets;
+static RTPacketIngest ingest;
+static MeterPeakCapture meterPeaks;
+static tagVBAN_VMRT_PACKET mixer; // what the synthetic Voicemeeter reports
+
+struct ScenarioCost
+{
+    std::string name;
+    uint32_t frames;
+    uint32_t pixelsPerFrame;
+    uint32_t renderUsPerFrame;
+};
+
+static std::vector<ScenarioCost> baseline;
+static std::vector<ScenarioCost> measured;
+static int failures = 0;
+
+static void setStripGain(uint8_t strip, int16_t gainDb100)
+{
+    uint8_t *layers = reinterpret_cast<uint8_t *>(&mixer) + offsetof(tagVBAN_VMRT_PACKET, stripGaindB100Layer1);
+    memcpy(layers + VMRT_STRIP_GAIN_INDEX(strip) * sizeof(int16_t), &gainDb100, sizeof(gainDb100));
+}
+
+static void setLevels(int16_t levelDb100)
+{
+    for (int16_t &level : mixer.inputLeveldB100)
+        level = levelDb100;
+}
+
+static void sendPacket()
+{
+    mixer.frameCounter++;
+    ingest.ingest(VBANPacketView(reinterpret_cast<const uint8_t *>(&mixer), sizeof(mixer)), *packets.beginWrite(), packets.lastPublished());
+    packets.publish();
+    meterPeaks.capture(mixer.inputLeveldB100);
+    DisplayManager::requestFrame(WAKE_PACKET);
+}
+
+// Keeps the RT stream going for a while, like Voicemeeter would
+static void stream(unsigned long durationMs)
+{
+    unsigned long end = millis() + durationMs;
+    while (millis() < end)
+    {
+        sendPacket();
+        delay(PACKET_INTERVAL_MS);
+    }
+}
+
+// Streams until the display stopped flushing; levels must be constant by then
+static bool settle()
+{
+    unsigned long start = millis();
+    unsigned long quietSince = millis();
+    uint64_t pixels = NativeHal::getPixelsPushed();
+    while (millis() - quietSince < SETTLE_MS)
+    {
+        if (millis() - start > SETTLE_TIMEOUT_MS)
+            return false;
+        stream(PACKET_INTERVAL_MS);
+        uint64_t now = NativeHal::getPixelsPushed();
+        if (now != pixels)
+        {
+            pixels = now;
+            quietSince = millis();
+        }
+    }
+    return true;
+}
+
+// LVGL coordinates; the panel is mounted upside down (LV_DISPLAY_ROTATION_180) and LVGL rotates touches back
+static void touchAt(bool pressed, int32_t x, int32_t y)
+{
+    NativeHal::setTouch(pressed, TFT_WIDTH - 1 - x, TFT_HEIGHT - 1 - y);
+}
+
+static void tap(int32_t x, int32_t y, unsigned long holdMs = 100)
+{
+    touchAt(true, x, y);
+    stream(holdMs);
+    touchAt(false, x, y);
+    stream(200);
+}
+
+static void swipe(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    const int steps = 10;
+    for (int i = 0; i <= steps; i++)
+    {
+        touchAt(true, x0 + (x1 - x0) * i / steps, y0 + (y1 - y0) * i / steps);
+        stream(PACKET_INTERVAL_MS);
+    }
+    touchAt(false, x1, y1);
+    stream(200);
+}
+
+static bool readPPM(const std::string &path, std::vector<uint8_t> &rgb)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    int w = 0, h = 0, max = 0;
+    bool ok = fscanf(file, "P6 %d %d %d", &w, &h, &max) == 3 && fgetc(file) != EOF && w == TFT_WIDTH && h == TFT_HEIGHT && max == 255;
+    rgb.resize(w * h * 3);
+    ok = ok && fread(rgb.data(), 1, rgb.size(), file) == rgb.size();
+    fclose(file);
+    return ok;
+}
+
+static void writePPM(const std::string &path, const std::vector<uint8_t> &rgb)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file)
+        return;
+    fprintf(file, "P6\n%d %d\n255\n", TFT_WIDTH, TFT_HEIGHT);
+    fwrite(rgb.data(), 1, rgb.size(), file);
+    fclose(file);
+}
+
+// Same RGB565 -> RGB888 expansion as NativeHal::writeFramebufferPPM
+static std::vector<uint8_t> toRGB(const uint16_t *pixels)
+{
+    std::vector<uint8_t> rgb(TFT_WIDTH * TFT_HEIGHT * 3);
+    for (uint32_t i = 0; i < TFT_WIDTH * TFT_HEIGHT; i++)
+    {
+        rgb[i * 3] = (pixels[i] >> 8) & 0xf8;
+        rgb[i * 3 + 1] = (pixels[i] >> 3) & 0xfc;
+        rgb[i * 3 + 2] = (pixels[i] << 3) & 0xf8;
+    }
+    return rgb;
+}
+
+static std::vector<uint8_t> framebufferRGB()
+{
+    return toRGB(NativeHal::getFramebuffer());
+}
+
+static void compareImage(const std::string &name)
+{
+    if (!haveGoldens)
+        return;
+    std::vector<uint8_t> current = framebufferRGB();
+    std::string goldenPath = std::string(goldenDir) + "/" + name + ".ppm";
+    if (updateGoldens)
+    {
+        writePPM(goldenPath, current);
+        return;
+    }
+
+    std::vector<uint8_t> golden;
+    if (!readPPM(goldenPath, golden))
+    {
+        printf("FAIL %s: no golden image at %s (record with --update)\n", name.c_str(), goldenPath.c_str());
+        failures++;
+        return;
+    }
+    std::vector<uint8_t> diff(current.size());
+    uint32_t differing = 0;
+    for (size_t i = 0; i < current.size(); i += 3)
+    {
+        bool same = memcmp(&current[i], &golden[i], 3) == 0;
+        differing += !same;
+        // Differences in red over a dimmed copy of the golden
+        diff[i] = same ? golden[i] / 4 : 255;
+        diff[i + 1] = same ? golden[i + 1] / 4 : 0;
+        diff[i + 2] = same ? golden[i + 2] / 4 : 0;
+    }
+    if (differing > maxDiffPixels)
+    {
+        std::string base = std::string(outDir) + "/" + name;
+        writePPM(base + ".ppm", current);
+        writePPM(base + ".diff.ppm", diff);
+        printf("FAIL %s: %u pixels differ from the golden image, see %s.diff.ppm\n", name.c_str(), differing, base.c_str());
+        failures++;
+    }
+}
+
+static void loadBaseline()
+{
+    std::string path = std::string(goldenDir) + "/costs.csv";
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file)
+        return;
+    char line[160];
+    while (fgets(line, sizeof(line), file))
+    {
+        char name[64];
+        ScenarioCost c;
+        if (line[0] == '#' || sscanf(line, "%63[^,],%u,%u,%u", name, &c.frames, &c.pixelsPerFrame, &c.renderUsPerFrame) != 4)
+            continue;
+        c.name = name;
+        baseline.push_back(c);
+    }
+    fclose(file);
+}
+
+static void saveBaseline()
+{
+    std::string path = std::string(goldenDir) + "/costs.csv";
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+        return;
+    fprintf(file, "# scenario,frames,pixels_per_frame,render_us_per_frame\n");
+    for (const ScenarioCost &c : measured)
+        fprintf(file, "%s,%u,%u,%u\n", c.name.c_str(), c.frames, c.pixelsPerFrame, c.renderUsPerFrame);
+    fclose(file);
+}
+
+static void compareCost(const ScenarioCost &c)
+{
+    for (const ScenarioCost &b : baseline)
+    {
+        if (b.name != c.name)
+            continue;
+        float limit = 1.0f + costTolerance / 100.0f;
+        if (c.pixelsPerFrame > b.pixelsPerFrame * limit)
+        {
+            printf("FAIL %s: %u px/frame, baseline %u\n", c.name.c_str(), c.pixelsPerFrame, b.pixelsPerFrame);
+            failures++;
+        }
+        if (checkTime && c.renderUsPerFrame > b.renderUsPerFrame * limit)
+        {
+            printf("FAIL %s: %u us/frame, baseline %u\n", c.name.c_str(), c.renderUsPerFrame, b.renderUsPerFrame);
+            failures++;
+        }
+        return;
+    }
+    if (haveGoldens && !updateGoldens)
+    {
+        printf("FAIL %s: no cost baseline in %s/costs.csv (record with --update)\n", c.name.c_str(), goldenDir);
+        failures++;
+    }
+}
+
+struct ArcCase
+{
+    const char *name;
+    int32_t size;           // object width and height, as on the Monitor
+    int32_t mainWidth;      // 0 for the indicator-only level meters
+    int32_t indicatorWidth;
+    int32_t value;          // 0..6000
+    int32_t rotation;
+    lv_opa_t indicatorOpa;
+};
+
+alignas(64) static uint16_t arcFrame[TFT_WIDTH * TFT_HEIGHT]; // direct render target of the arc display
+
+static void arcFlush(lv_display_t *display, const lv_area_t *area, uint8_t *pixels)
+{
+    lv_display_flush_ready(display);
+}
+
+// Styled like the SquareLine arcs in ui_Monitor.c: flat ends, no knob, range 0..6000
+static lv_obj_t *createArc(const ArcCase &c)
+{
+    lv_obj_t *arc = lv_arc_create(lv_screen_active());
+    lv_obj_set_size(arc, c.size, c.size);
+    lv_obj_center(arc);
+    lv_obj_remove_flag(arc, LV_OBJ_FLAG_CLICKABLE);
+    lv_arc_set_range(arc, 0, 6000);
+    lv_arc_set_value(arc, c.value);
+    lv_arc_set_rotation(arc, c.rotation);
+    lv_obj_set_style_arc_width(arc, c.mainWidth, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_arc_rounded(arc, false, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_arc_color(arc, lv_color_hex(0x2B3A33), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_arc_width(arc, c.indicatorWidth, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    lv_obj_set_style_arc_rounded(arc, false, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    lv_obj_set_style_arc_color(arc, lv_color_hex(0x70C399), LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    lv_obj_set_style_arc_opa(arc, c.indicatorOpa, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(arc, LV_OPA_TRANSP, LV_PART_KNOB | LV_STATE_DEFAULT);
+    return arc;
+}
+
+static std::vector<uint16_t> renderArc(const ArcCase &c, bool cached, bool &attached)
+{
+    lv_obj_t *arc = createArc(c);
+    attached = cached && RingMaskCache::attach(arc);
+    lv_obj_invalidate(lv_screen_active());
+    lv_refr_now(nullptr);
+    lv_obj_delete(arc);
+    return std::vector<uint16_t>(arcFrame, arcFrame + TFT_WIDTH * TFT_HEIGHT);
+}
+
+static uint8_t channelDiff(uint16_t a, uint16_t b)
+{
+    int r = abs(((a >> 8) & 0xf8) - ((b >> 8) & 0xf8));
+    int g = abs(((a >> 3) & 0xfc) - ((b >> 3) & 0xfc));
+    int bl = abs(((a << 3) & 0xf8) - ((b << 3) & 0xf8));
+    return (uint8_t)LV_MAX(r, LV_MAX(g, bl));
+}
+
+// RingMaskCache against LVGL's own arc drawing, on a throwaway LVGL instance ahead of DisplayManager::begin()
+static void compareArcDrawing()
+{
+    const ArcCase cases[] = {
+        {"ring_240_2500", 240, 18, 18, 2500, 0, LV_OPA_COVER}, // strip gain rings
+        {"ring_200_empty", 200, 18, 18, 0, 0, LV_OPA_COVER},
+        {"ring_160_full", 160, 18, 18, 6000, 0, LV_OPA_COVER},
+        {"meter_222_5000", 222, 0, 9, 5000, 0, LV_OPA_COVER}, // level meter, sweep past 180 degrees
+        {"ring_200_rotated", 200, 18, 18, 4321, 90, LV_OPA_COVER},
+        {"ring_240_translucent", 240, 18, 18, 3000, 0, LV_OPA_50},
+    };
+
+    lv_init();
+    lv_display_t *display = lv_display_create(TFT_WIDTH, TFT_HEIGHT);
+    lv_display_set_color_format(display, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_flush_cb(display, arcFlush);
+    lv_display_set_buffers(display, arcFrame, nullptr, sizeof(arcFrame), LV_DISPLAY_RENDER_MODE_DIRECT);
+    lv_obj_set_style_bg_color(lv_screen_active(), lv_color_black(), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(lv_screen_active(), LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    for (const ArcCase &c : cases)
+    {
+        bool attached;
+        std::vector<uint16_t> reference = renderArc(c, false, attached);
+        uint32_t sweeps = RingMaskCache::getCachedSweeps();
+        std::vector<uint16_t> cached = renderArc(c, true, attached);
+        bool usedCache = attached && RingMaskCache::getCachedSweeps() > sweeps;
+
+        uint32_t drawn = 0, differing = 0;
+        uint8_t worst = 0;
+        std::vector<uint16_t> diff(reference.size());
+        for (size_t i = 0; i < reference.size(); i++)
+        {
+            drawn += reference[i] || cached[i]; // the background is black
+            uint8_t d = channelDiff(reference[i], cached[i]);
+            worst = LV_MAX(worst, d);
+            differing += d > ARC_CHANNEL_TOLERANCE;
+            diff[i] = d > ARC_CHANNEL_TOLERANCE ? 0xF800 : (reference[i] >> 2) & 0x39E7; // red over a dimmed copy
+        }
+        uint32_t limit = (uint32_t)(drawn * ARC_MAX_DIFF_PERCENT / 100.0f);
+        bool ok = usedCache && drawn && differing <= limit;
+        printf("%-22s %6u px drawn %5u differ (limit %u), worst channel %3u%s\n", c.name, drawn, differing, limit, worst,
+               usedCache ? "" : ", cache not used");
+        if (!ok)
+        {
+            std::string base = std::string(outDir) + "/" + c.name;
+            writePPM(base + ".lvgl.ppm", toRGB(reference.data()));
+            writePPM(base + ".cache.ppm", toRGB(cached.data()));
+            writePPM(base + ".diff.ppm", toRGB(diff.data()));
+            printf("FAIL %s: cached arc differs from lv_draw_arc, see %s.diff.ppm\n", c.name, base.c_str());
+            failures++;
+        }
+    }
+
+    lv_deinit();
+    RingMaskCache::reset(); // leaves the ring and arc tables to the Monitor's own arcs
+}
+
+// Runs one step of the walk-through, then checks what is on screen and what it cost to get there
+template <typename Step>
+static void scenario(const char *name, Step step)
+{
+    FlushStats before = displayManager.getFlushStats();
+    step();
+    if (!settle())
+    {
+        printf("FAIL %s: display still flushing after %lu ms\n", name, SETTLE_TIMEOUT_MS);
+        failures++;
+    }
+    FlushStats after = displayManager.getFlushStats();
+
+    ScenarioCost c;
+    c.name = name;
+    c.frames = after.frames - before.frames;
+    c.pixelsPerFrame = c.frames ? (uint32_t)((after.pixels - before.pixels) / c.frames) : 0;
+    c.renderUsPerFrame = c.frames ? (uint32_t)((after.renderUs - before.renderUs) / c.frames) : 0;
+    measured.push_back(c);
+    printf("%-18s %5u frames %7u px/frame %6u us/frame\n", name, c.frames, c.pixelsPerFrame, c.renderUsPerFrame);
+
+    compareImage(name);
+    compareCost(c);
+}
+
+static void parseArgs()
+{
+    // NativeHal's main() keeps argv for us
+    int argc = NativeHal::getArgc();
+    char **argv = NativeHal::getArgv();
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--update"))
+            updateGoldens = true;
+        else if (!strcmp(argv[i], "--check-time"))
+            checkTime = true;
+        else if (!strcmp(argv[i], "--golden") && i + 1 < argc)
+            goldenDir = argv[++i];
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc)
+            outDir = argv[++i];
+        else if (!strcmp(argv[i], "--max-diff-pixels") && i + 1 < argc)
+            maxDiffPixels = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--cost-tolerance") && i + 1 < argc)
+            costTolerance = atof(argv[++i]);
+        else
+        {
+            printf("Unknown argument %s\n", argv[i]);
+            exit(2);
+        }
+    }
+}
+
+void setup()
+{
+    parseArgs();
+    NativeHal::setTimeScale(1); // render times are measured against the wall clock
+    NativeHal::setBattery(3.9f, 80.0f, 0.0f);
+    if (updateGoldens)
+        mkdir(goldenDir, 0755);
+    struct stat st;
+    haveGoldens = stat(goldenDir, &st) == 0 && S_ISDIR(st.st_mode);
+    if (haveGoldens)
+        loadBaseline();
+    else
+    {
+        // Reported once rather than per scenario
+        printf("FAIL no golden images in %s (record with --update and commit them)\n", goldenDir);
+        failures++;
+    }
+
+    compareArcDrawing();
+
+    memcpy(mixer.magic, "VBAN", 4);
+    mixer.voicemeeterType = 3;
+    setLevels(METER_FLOOR_DB100);
+    for (uint8_t strip = 0; strip < 8; strip++)
+        setStripGain(strip, -1200);
+
+    displayManager.setPacketSource(&packets);
+    displayManager.setMeterSource(&meterPeaks);
+    displayManager.begin(&powerManager);
+    displayManager.showLatestBatteryData(80.0f, 5, 3.9f);
+    displayManager.showIpAddress(0x0201A8C0); // 192.168.1.2
+
+    scenario("loading", []() {});
+
+    scenario("monitor_idle", []()
+             {
+                 displayManager.setConnectionStatus(true);
+                 stream(1500); // loading -> monitor transition
+             });
+
+    scenario("monitor_levels", []()
+             {
+                 // A 2 s burst of programme material, then a steady tone for the meters to settle on
+                 for (int i = 0; i < 100; i++)
+                 {
+                     for (uint8_t ch = 0; ch < 34; ch++)
+                         mixer.inputLeveldB100[ch] = (int16_t)(-2400 + 1800 * sinf(i * 0.3f + ch));
+                     stream(PACKET_INTERVAL_MS);
+                 }
+                 setLevels(-1800);
+             });
+
+    scenario("monitor_gains", []()
+             {
+                 setStripGain(5, 0);
+                 setStripGain(6, -3000);
+                 setStripGain(7, 600);
+                 mixer.stripState[5] = VMRTSTATE_MODE_BUSA1 | VMRTSTATE_MODE_BUSA3;
+                 mixer.stripState[6] = VMRTSTATE_MODE_BUSA2;
+             });
+
+    scenario("monitor_selected", []()
+             { tap(200, 120); }); // increment-selected-channel button on the right
+
+    scenario("output_matrix", []()
+             { tap(120, 205); }); // output preview under the dB label
+
+    scenario("output_matrix_paged", []()
+             {
+                 mixer.stripState[0] = VMRTSTATE_MODE_BUSB1 | VMRTSTATE_MODE_BUSA5;
+                 swipe(40, 120, 200, 120); // back to strips 4-6
+                 swipe(40, 120, 200, 120); // strips 1-3
+                 swipe(120, 200, 120, 40); // A4, A5, B1
+             });
+
+    scenario("monitor_return", []()
+             { swipe(120, 60, 120, 200); });
+
+    scenario("config", []()
+             { tap(120, 120, 800); }); // long press on the dB label
+
+    if (updateGoldens)
+        saveBaseline();
+    printf("%s\n", failures ? "screen harness: FAILED" : "screen harness: ok");
+    exit(failures ? 1 : 0);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,126 @@
+/*
+    Concurrency stress test for TripleBuffer (include/TripleBuffer.h).
+
+    A publisher thread stamps every word of a snapshot the size of an RT packet with
+    an increasing sequence number and publishes it, as the UDP receive callback does;
+    a reader thread acquires snapshots as fast as it can, as the display task does,
+    and checks each one while it owns it:
+      - every word carries the same sequence (no torn snapshot),
+      - sequences never go backwards,
+      - isNew is set exactly when the sequence changed since the last acquire(),
+      - the snapshot does not change under the reader before its next acquire().
+    The publisher also checks lastPublished() against what it published last.
+    Exits non-zero on the first violation.
+
+    Build:  g++ -std=gnu++17 -O2 -I include tools/triple_buffer_stress/triple_buffer_stress.cpp -o triple_buffer_stress -pthread
+    Run:    ./triple_buffer_stress [--publishes 3000000]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include "TripleBuffer.h"
+
+struct Snapshot
+{
+    uint32_t words[1412 / sizeof(uint32_t)]; // sizeof(tagVBAN_VMRT_PACKET)
+};
+
+static const uint32_t WORDS = sizeof(Snapshot::words) / sizeof(uint32_t);
+
+static TripleBuffer<Snapshot> buffer;
+static std::atomic<bool> done(false);
+static std::atomic<bool> failed(false);
+
+static void fail(const char *what, uint32_t expected, uint32_t found)
+{
+    if (!failed.exchange(true))
+        fprintf(stderr, "FAIL %s: expected %u, found %u\n", what, expected, found);
+}
+
+// Index of the first word that differs from word 0, or WORDS when the snapshot is whole
+static uint32_t firstTornWord(const Snapshot &s)
+{
+    for (uint32_t i = 1; i < WORDS; i++)
+        if (s.words[i] != s.words[0])
+            return i;
+    return WORDS;
+}
+
+static void publisher(uint32_t publishes)
+{
+    for (uint32_t sequence = 1; sequence <= publishes && !failed; sequence++)
+    {
+        Snapshot *slot = buffer.beginWrite();
+        for (uint32_t i = 0; i < WORDS; i++)
+            slot->words[i] = sequence;
+        buffer.publish();
+        const Snapshot *published = buffer.lastPublished();
+        if (!published || published->words[0] != sequence || firstTornWord(*published) != WORDS)
+            fail("lastPublished", sequence, published ? published->words[0] : 0);
+    }
+    done = true;
+}
+
+static void reader(uint32_t &acquires, uint32_t &fresh)
+{
+    uint32_t last = 0; // slots start zeroed, which reads as sequence 0
+    bool first = true;
+    while (!failed)
+    {
+        bool finished = done.load();
+        bool isNew = false;
+        const Snapshot *s = buffer.acquire(&isNew);
+        acquires++;
+        uint32_t sequence = s->words[0];
+        uint32_t torn = firstTornWord(*s);
+        if (torn != WORDS)
+            fail("torn snapshot", sequence, s->words[torn]);
+        else if (sequence < last)
+            fail("sequence went backwards", last, sequence);
+        else if (!first && isNew != (sequence != last))
+            fail("isNew", sequence != last, isNew);
+        fresh += isNew;
+        // Still ours until the next acquire(): the publisher must not be writing into it
+        if (firstTornWord(*s) != WORDS || s->words[0] != sequence)
+            fail("snapshot changed while owned", sequence, s->words[0]);
+        last = sequence;
+        first = false;
+        if (finished)
+            break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t publishes = 3000000;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--publishes") && i + 1 < argc)
+            publishes = strtoul(argv[++i], nullptr, 10);
+        else
+        {
+            fprintf(stderr, "usage: %s [--publishes n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    uint32_t acquires = 0, fresh = 0;
+    std::thread readThread(reader, std::ref(acquires), std::ref(fresh));
+    std::thread publishThread(publisher, publishes);
+    publishThread.join();
+    readThread.join();
+
+    // The last acquire() after the publisher finished must have returned the final snapshot
+    uint32_t final = buffer.current()->words[0];
+    if (!failed && final != publishes)
+        fail("final snapshot", publishes, final);
+
+    printf("%u publishes, %u acquires, %u new snapshots seen, publish count %u\n", publishes, acquires, fresh, buffer.getPublishCount());
+    if (fresh < 1000)
+        printf("note: few snapshots changed hands, the threads hardly overlapped (single core?)\n");
+    printf("%s\n", failed ? "triple buffer stress: FAILED" : "triple buffer stress: ok");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,338 @@
+/*
+    Voicemeeter Potato stand-in for end-to-end latency benchmarking on a Linux host.
+
+    Speaks the same VBAN dialect as NetworkingManager:
+      - accepts RT-register service packets (createRTPPacket) and streams
+        VBAN_SERVICE_RTPACKET frames back to the registered client at --rate Hz
+      - applies VBAN-TEXT commands such as "strip(5).gain += 1.25" or "Strip[5].A1 = 1"
+        to a simulated mixer state
+      - reports, per command, how long it took until the change left in an RT packet
+
+    Build:  g++ -std=gnu++17 -O2 -I include tools/vm_standin/vm_standin.cpp -o vm_standin -pthread
+    Run:    ./vm_standin [--bind 127.0.0.2] [--port 6980] [--rate 30] [--duration 0] [--quiet]
+
+    The native firmware build (pio run -e native) binds 127.0.0.1:6980 and sends to
+    127.0.0.2:6980 by default, so both can share the loopback interface.
+*/
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <signal.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "VBANCodec.h"
+
+using Clock = std::chrono::steady_clock;
+
+static const float GAIN_MIN_DB = -60.0f;
+static const float GAIN_MAX_DB = 12.0f;
+
+struct PendingCommand
+{
+    std::string text;
+    Clock::time_point received;
+};
+
+struct Options
+{
+    const char *bindAddress = "127.0.0.2";
+    uint16_t port = 6980;
+    double rateHz = 30.0;
+    double durationS = 0;
+    bool quiet = false;
+};
+
+static volatile sig_atomic_t s_stop = 0;
+
+static void onSignal(int)
+{
+    s_stop = 1;
+}
+
+static double msSince(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+class SimulatedPotato
+{
+public:
+    SimulatedPotato()
+    {
+        memset(&packet, 0, sizeof(packet));
+        memcpy(packet.magic, "VBAN", 4);
+        packet.subProtocol = VBAN_PROTOCOL_SERVICE;
+        packet.function = 0;
+        packet.service = VBAN_SERVICE_RTPACKET;
+        strncpy((char *)packet.streamName, "Voicemeeter-RTP", sizeof(packet.streamName));
+        packet.voicemeeterType = 3; // Potato
+        packet.buffersize = 512;
+        packet.voicemeeterVersion = 0x03000000;
+        packet.samplerate = 48000;
+        for (int i = 0; i < 8; i++)
+        {
+            packet.stripGaindB100Layer1[i] = 0;
+            packet.stripState[i] = VMRTSTATE_MODE_BUSA1;
+            snprintf(packet.stripLabelUTF8c60[i], 60, "Strip %d", i + 1);
+            snprintf(packet.busLabelUTF8c60[i], 60, i < 5 ? "A%d" : "B%d", i < 5 ? i + 1 : i - 4);
+        }
+    }
+
+    // Applies one statement; returns false if it was not understood
+    bool apply(const std::string &statement)
+    {
+        std::string s;
+        for (char c : statement)
+            if (!isspace((unsigned char)c))
+                s += (char)tolower((unsigned char)c);
+        if (s.empty())
+            return true;
+
+        const char *cursor = s.c_str();
+        bool isStrip = false;
+        if (strncmp(cursor, "strip", 5) == 0)
+        {
+            isStrip = true;
+            cursor += 5;
+        }
+        else if (strncmp(cursor, "bus", 3) == 0)
+            cursor += 3;
+        else
+            return strncmp(cursor, "command.", 8) == 0 || strncmp(cursor, "system.", 7) == 0; // accepted, no RT-visible effect
+
+        if (*cursor != '[' && *cursor != '(')
+            return false;
+        char *end;
+        long index = strtol(cursor + 1, &end, 10);
+        if (index < 0 || index > 7 || (*end != ']' && *end != ')') || end[1] != '.')
+            return false;
+        cursor = end + 2;
+
+        const char *op = strpbrk(cursor, "+-=");
+        if (!op)
+            return false;
+        std::string field(cursor, op - cursor);
+        char mode = '=';
+        if ((op[0] == '+' || op[0] == '-') && op[1] == '=')
+        {
+            mode = op[0];
+            op++;
+        }
+        if (*op != '=')
+            return false;
+        float value = strtof(op + 1, &end);
+        if (end == op + 1)
+            return false;
+
+        if (field == "gain")
+        {
+            int16_t &gain = isStrip ? packet.stripGaindB100Layer1[index] : packet.busGaindB100[index];
+            float db = gain / 100.0f;
+            db = mode == '+' ? db + value : mode == '-' ? db - value : value;
+            db = std::min(GAIN_MAX_DB, std::max(GAIN_MIN_DB, db));
+            gain = (int16_t)lroundf(db * 100.0f);
+            return true;
+        }
+
+        uint32_t bit = 0;
+        if (field == "mute")
+            bit = VMRTSTATE_MODE_MUTE;
+        else if (isStrip && field.size() == 2 && (field[0] == 'a' || field[0] == 'b'))
+        {
+            static const uint32_t aBits[] = {VMRTSTATE_MODE_BUSA1, VMRTSTATE_MODE_BUSA2, VMRTSTATE_MODE_BUSA3, VMRTSTATE_MODE_BUSA4, VMRTSTATE_MODE_BUSA5};
+            static const uint32_t bBits[] = {VMRTSTATE_MODE_BUSB1, VMRTSTATE_MODE_BUSB2, VMRTSTATE_MODE_BUSB3};
+            int n = field[1] - '1';
+            if (field[0] == 'a' && n >= 0 && n < 5)
+                bit = aBits[n];
+            else if (field[0] == 'b' && n >= 0 && n < 3)
+                bit = bBits[n];
+        }
+        if (!bit || mode != '=')
+            return false;
+        uint32_t &state = isStrip ? packet.stripState[index] : packet.busState[index];
+        state = value != 0 ? (state | bit) : (state & ~bit);
+        return true;
+    }
+
+    // Meter levels follow a slow sine per channel so level arcs have something to draw
+    const tagVBAN_VMRT_PACKET &nextFrame(double seconds)
+    {
+        packet.frameCounter++;
+        for (int i = 0; i < 34; i++)
+            packet.inputLeveldB100[i] = (int16_t)(-3000 + 2500 * sin(seconds * 2.0 + i * 0.4));
+        for (int i = 0; i < 64; i++)
+            packet.outputLeveldB100[i] = (int16_t)(-3000 + 2500 * sin(seconds * 1.5 + i * 0.3));
+        return packet;
+    }
+
+private:
+    tagVBAN_VMRT_PACKET packet;
+};
+
+static bool parseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--bind" && hasValue)
+            options.bindAddress = argv[++i];
+        else if (arg == "--port" && hasValue)
+            options.port = (uint16_t)atoi(argv[++i]);
+        else if (arg == "--rate" && hasValue)
+            options.rateHz = atof(argv[++i]);
+        else if (arg == "--duration" && hasValue)
+            options.durationS = atof(argv[++i]);
+        else if (arg == "--quiet")
+            options.quiet = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--bind addr] [--port n] [--rate hz] [--duration s] [--quiet]\n", argv[0]);
+            return false;
+        }
+    }
+    return options.rateHz > 0;
+}
+
+static void printSummary(std::vector<double> &latencies, uint32_t framesSent, uint32_t textPackets, uint32_t commandsRejected)
+{
+    printf("[vm] frames sent: %u, commands applied: %zu in %u VBAN-TEXT packets, rejected: %u\n", framesSent, latencies.size(), textPackets, commandsRejected);
+    if (latencies.empty())
+        return;
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for (double l : latencies)
+        sum += l;
+    size_t p99 = std::min(latencies.size() - 1, (size_t)(latencies.size() * 0.99));
+    printf("[vm] command->RT latency ms: min %.2f  avg %.2f  p50 %.2f  p99 %.2f  max %.2f\n",
+           latencies.front(), sum / latencies.size(), latencies[latencies.size() / 2], latencies[p99], latencies.back());
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(options.port);
+    if (fd < 0 || inet_pton(AF_INET, options.bindAddress, &local.sin_addr) != 1 || bind(fd, (sockaddr *)&local, sizeof(local)) != 0)
+    {
+        perror("[vm] bind");
+        return 1;
+    }
+    printf("[vm] Voicemeeter stand-in on %s:%u, streaming RT packets at %.1f Hz\n", options.bindAddress, options.port, options.rateHz);
+
+    SimulatedPotato potato;
+    sockaddr_in client = {};
+    bool hasClient = false;
+    Clock::time_point registrationExpiry;
+    std::vector<PendingCommand> pending;
+    std::vector<double> latencies;
+    uint32_t framesSent = 0, textPackets = 0, commandsRejected = 0;
+
+    const auto start = Clock::now();
+    const auto framePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.rateHz));
+    auto nextFrame = start + framePeriod;
+
+    while (!s_stop)
+    {
+        auto now = Clock::now();
+        if (options.durationS > 0 && msSince(start, now) > options.durationS * 1000.0)
+            break;
+
+        // Wait for a datagram until the next frame is due
+        timeval timeout = {0, 0};
+        if (nextFrame > now)
+        {
+            auto wait = std::chrono::duration_cast<std::chrono::microseconds>(nextFrame - now).count();
+            timeout.tv_sec = wait / 1000000;
+            timeout.tv_usec = wait % 1000000;
+        }
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(fd, &readable);
+        if (select(fd + 1, &readable, nullptr, nullptr, &timeout) > 0)
+        {
+            uint8_t buffer[2048];
+            sockaddr_in remote = {};
+            socklen_t remoteLength = sizeof(remote);
+            ssize_t length = recvfrom(fd, buffer, sizeof(buffer), 0, (sockaddr *)&remote, &remoteLength);
+            VBANPacketView view(buffer, length > 0 ? length : 0);
+            if (view.isVBAN() && view.protocol() == VBAN_PROTOCOL_SERVICE && view.serviceType() == VBAN_SERVICE_RTPACKETREGISTER)
+            {
+                // format_bit carries the registration timeout in seconds
+                uint8_t timeoutS = buffer[offsetof(tagVBAN_HEADER, format_bit)];
+                client = remote;
+                hasClient = true;
+                registrationExpiry = Clock::now() + std::chrono::seconds(timeoutS ? timeoutS : 10);
+                if (!options.quiet)
+                    printf("[vm] RT register from %s:%u for %us\n", inet_ntoa(remote.sin_addr), ntohs(remote.sin_port), timeoutS);
+            }
+            else if (view.isVBAN() && view.protocol() == VBAN_PROTOCOL_TXT)
+            {
+                auto received = Clock::now();
+                textPackets++;
+                std::string text((const char *)buffer + sizeof(tagVBAN_HEADER), length - sizeof(tagVBAN_HEADER));
+                size_t begin = 0;
+                while (begin <= text.size())
+                {
+                    size_t end = text.find_first_of(";\n\r", begin);
+                    if (end == std::string::npos)
+                        end = text.size();
+                    std::string statement = text.substr(begin, end - begin);
+                    if (statement.find_first_not_of(" \t\0", 0, 3) != std::string::npos)
+                    {
+                        if (potato.apply(statement))
+                            pending.push_back({statement, received});
+                        else
+                        {
+                            commandsRejected++;
+                            printf("[vm] rejected: '%s'\n", statement.c_str());
+                        }
+                    }
+                    begin = end + 1;
+                }
+            }
+        }
+
+        now = Clock::now();
+        if (now < nextFrame)
+            continue;
+        nextFrame += framePeriod;
+        if (nextFrame < now)
+            nextFrame = now + framePeriod; // fell behind, don't burst
+
+        if (!hasClient || now > registrationExpiry)
+            continue;
+        const tagVBAN_VMRT_PACKET &frame = potato.nextFrame(msSince(start, now) / 1000.0);
+        sendto(fd, &frame, sizeof(frame), 0, (sockaddr *)&client, sizeof(client));
+        framesSent++;
+
+        auto sent = Clock::now();
+        for (const auto &command : pending)
+        {
+            double latency = msSince(command.received, sent);
+            latencies.push_back(latency);
+            if (!options.quiet)
+                printf("[vm] '%s' reflected in frame %u after %.2f ms\n", command.text.c_str(), frame.frameCounter, latency);
+        }
+        pending.clear();
+    }
+
+    printSummary(latencies, framesSent, textPackets, commandsRejected);
+    close(fd);
+    return 0;
+}